@@ -0,0 +1,202 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+std::atomic<std::uint64_t> i3neostatus::bench::impl::allocations{0};
+
+// every form of the global operator new counts one allocation, the
+// deallocating forms are needed because the storage comes from malloc()
+void *operator new(const std::size_t size) {
+  if (void *ptr{i3neostatus::bench::impl::allocate(size)}; ptr != nullptr) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](const std::size_t size) { return operator new(size); }
+
+void *operator new(const std::size_t size, const std::nothrow_t &) noexcept {
+  return i3neostatus::bench::impl::allocate(size);
+}
+
+void *operator new[](const std::size_t size, const std::nothrow_t &) noexcept {
+  return i3neostatus::bench::impl::allocate(size);
+}
+
+void *operator new(const std::size_t size, const std::align_val_t alignment) {
+  if (void *ptr{i3neostatus::bench::impl::allocate(size, alignment)};
+      ptr != nullptr) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](const std::size_t size,
+                     const std::align_val_t alignment) {
+  return operator new(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+i3neostatus::bench::state::state(const std::size_t iterations,
+                                 const struct settings &settings)
+    : m_iterations{iterations}, m_producer_count{settings.producer_count},
+      m_elapsed{clock::duration::zero()}, m_allocations{0}, m_start{},
+      m_start_allocations{0}, m_counters{} {}
+
+i3neostatus::bench::state::~state() {}
+
+std::size_t i3neostatus::bench::state::iterations() const {
+  return m_iterations;
+}
+
+std::size_t i3neostatus::bench::state::producer_count() const {
+  return m_producer_count;
+}
+
+void i3neostatus::bench::state::start() {
+  m_start_allocations = bench::allocations();
+  m_start = clock::now();
+}
+
+void i3neostatus::bench::state::stop() {
+  m_elapsed += (clock::now() - m_start);
+  m_allocations += (bench::allocations() - m_start_allocations);
+}
+
+i3neostatus::bench::clock::duration
+i3neostatus::bench::state::elapsed() const {
+  return m_elapsed;
+}
+
+std::uint64_t i3neostatus::bench::state::allocations() const {
+  return m_allocations;
+}
+
+void i3neostatus::bench::state::set_counter(const std::string_view name,
+                                            const double value) {
+  m_counters.emplace_back(name, value);
+}
+
+const std::vector<i3neostatus::bench::counter> &
+i3neostatus::bench::state::counters() const {
+  return m_counters;
+}
+
+i3neostatus::bench::unique_fd::unique_fd(const int fd, const std::string &call)
+    : m_fd{fd} {
+  if (m_fd == -1) {
+    throw std::system_error{errno, std::generic_category(), (call + "()")};
+  }
+}
+
+i3neostatus::bench::unique_fd::~unique_fd() { close(m_fd); }
+
+int i3neostatus::bench::unique_fd::get() const { return m_fd; }
+
+i3neostatus::bench::result
+i3neostatus::bench::run(const benchmark &benchmark,
+                        const struct settings &settings) {
+  std::size_t iterations{1};
+  while (true) {
+    state state{iterations, settings};
+    benchmark.run(state);
+    if ((state.elapsed() >= settings.min_time) ||
+        (iterations >= impl::k_max_iterations)) {
+      return {.iterations{iterations},
+              .ns_per_op{
+                  std::chrono::duration<double, std::nano>{state.elapsed()}
+                      .count() /
+                  static_cast<double>(iterations)},
+              .allocations_per_op{static_cast<double>(state.allocations()) /
+                                  static_cast<double>(iterations)},
+              .counters{state.counters()}};
+    }
+    // aim past min_time, but grow by at most ten times per run so that a
+    // noisy short run does not overshoot by far
+    const double factor{std::clamp(
+        ((1.4 * std::chrono::duration<double>{settings.min_time}.count()) /
+         std::max(std::chrono::duration<double>{state.elapsed()}.count(),
+                  1e-9)),
+        2.0, 10.0)};
+    iterations = std::min(
+        static_cast<std::size_t>(static_cast<double>(iterations) * factor),
+        impl::k_max_iterations);
+  }
+}
+
+void i3neostatus::bench::print_result(std::ostream &stream,
+                                      const benchmark &benchmark,
+                                      const result &result) {
+  const std::ios_base::fmtflags flags{stream.flags()};
+  const std::streamsize precision{stream.precision()};
+  stream << "{\"benchmark\":\"" << benchmark.name
+         << "\",\"iterations\":" << result.iterations << std::fixed
+         << std::setprecision(3) << ",\"ns_per_op\":" << result.ns_per_op
+         << ",\"allocs_per_op\":" << result.allocations_per_op;
+  for (const counter &cur_counter : result.counters) {
+    stream << ",\"" << cur_counter.first << "\":" << cur_counter.second;
+  }
+  stream << "}\n" << std::flush;
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+void i3neostatus::bench::print_result(std::ostream &stream, const check &check,
+                                      const check_result &result) {
+  stream << "{\"check\":\"" << check.name << "\",\"cases\":" << result.cases
+         << ",\"mismatches\":" << result.mismatches << "}\n"
+         << std::flush;
+}
+
+std::uint64_t i3neostatus::bench::allocations() {
+  return impl::allocations.load(std::memory_order_relaxed);
+}
+
+void *i3neostatus::bench::impl::allocate(const std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc((size != 0) ? (size) : (1));
+}
+
+void *i3neostatus::bench::impl::allocate(const std::size_t size,
+                                         const std::align_val_t alignment) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  const std::size_t align{static_cast<std::size_t>(alignment)};
+  // aligned_alloc() wants a multiple of the alignment
+  return std::aligned_alloc(align, (((size + align - 1) / align) * align));
+}
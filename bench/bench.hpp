@@ -0,0 +1,153 @@
+#ifndef I3NEOSTATUS_BENCH_BENCH_HPP
+#define I3NEOSTATUS_BENCH_BENCH_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace i3neostatus {
+namespace bench {
+using clock = std::chrono::steady_clock;
+
+// from the command line, the same for every benchmark
+struct settings {
+  clock::duration min_time{std::chrono::milliseconds{500}};
+  // for the benchmarks with one thread per plugin
+  std::size_t producer_count{64};
+};
+
+// a value a benchmark reports besides ns and allocations per operation,
+// already divided by whatever it is per
+using counter = std::pair<std::string_view, double>;
+
+// one run of a benchmark. it sets up its data, then brackets
+// state.iterations() operations with start() and stop(), more than once if
+// part of the work between them should not be measured
+class state {
+private:
+  std::size_t m_iterations;
+  std::size_t m_producer_count;
+  clock::duration m_elapsed;
+  std::uint64_t m_allocations;
+  clock::time_point m_start;
+  std::uint64_t m_start_allocations;
+  std::vector<counter> m_counters;
+
+public:
+  state(const std::size_t iterations, const struct settings &settings);
+  state(state &&other) noexcept = delete;
+  state(const state &other) = delete;
+
+public:
+  ~state();
+
+public:
+  state &operator=(state &&other) noexcept = delete;
+  state &operator=(const state &other) = delete;
+
+public:
+  std::size_t iterations() const;
+  std::size_t producer_count() const;
+  void start();
+  void stop();
+  clock::duration elapsed() const;
+  std::uint64_t allocations() const;
+  // after stop(), the value of the last run is reported
+  void set_counter(const std::string_view name, const double value);
+  const std::vector<counter> &counters() const;
+};
+
+using function = void (*)(state &state);
+
+struct benchmark {
+  std::string_view name;
+  function run;
+};
+
+struct result {
+  std::size_t iterations;
+  double ns_per_op;
+  double allocations_per_op;
+  std::vector<counter> counters;
+};
+
+// runs benchmark with a growing number of iterations until one run is
+// measured for at least settings.min_time, the shorter runs double as a
+// warm-up
+result run(const benchmark &benchmark, const struct settings &settings);
+// one JSON object per line, so that the output of several commits can be
+// compared with ordinary tools
+void print_result(std::ostream &stream, const benchmark &benchmark,
+                  const result &result);
+
+// the outcome of comparing an implementation with one it has to agree with
+// (a legacy or portable version) on generated inputs
+struct check_result {
+  std::size_t cases;
+  std::size_t mismatches;
+};
+
+// describes the first mismatch on std::cerr, run by --check instead of the
+// benchmarks
+using check_function = check_result (*)();
+
+struct check {
+  std::string_view name;
+  check_function run;
+};
+
+// one JSON object per line, like the benchmark results
+void print_result(std::ostream &stream, const check &check,
+                  const check_result &result);
+
+// closes fd when destroyed. fd is what call() returned, a failed call (fd ==
+// -1) is thrown as std::system_error
+class unique_fd {
+private:
+  int m_fd;
+
+public:
+  unique_fd(const int fd, const std::string &call);
+  unique_fd(unique_fd &&other) noexcept = delete;
+  unique_fd(const unique_fd &other) = delete;
+
+public:
+  ~unique_fd();
+
+public:
+  unique_fd &operator=(unique_fd &&other) noexcept = delete;
+  unique_fd &operator=(const unique_fd &other) = delete;
+
+public:
+  int get() const;
+};
+
+// calls of the global operator new so far, by every thread
+std::uint64_t allocations();
+
+// keeps the compiler from dropping the computation of value
+template <typename t_value> inline void do_not_optimize(const t_value &value) {
+  asm volatile("" : : "m"(value) : "memory");
+}
+
+namespace impl {
+extern std::atomic<std::uint64_t> allocations;
+
+// for the replacements of the global operator new, which count every call
+void *allocate(const std::size_t size);
+void *allocate(const std::size_t size, const std::align_val_t alignment);
+
+// a run this long is the last one, however short it was
+static constexpr std::size_t k_max_iterations{1'000'000'000};
+} // namespace impl
+} // namespace bench
+} // namespace i3neostatus
+
+#endif
@@ -0,0 +1,54 @@
+#include "benchmarks.hpp"
+
+#include "bench.hpp"
+#include "synthetic.hpp"
+
+#include "click_event_reader.hpp"
+#include "i3bar_data.hpp"
+#include "make_block.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+void i3neostatus::bench::benchmarks::click_event_reader_read(state &state) {
+  // read from a memfd instead of a pipe, so that a batch can be read again
+  // by seeking back, only the reader is measured and not a writer
+  static constexpr std::size_t k_batch_size{1024};
+  const make_block::theme_table theme_table{synthetic::make_theme(), false};
+  const std::vector<i3bar_data::block> blocks{
+      synthetic::blocks(theme_table, synthetic::k_block_count)};
+  const std::vector<std::string> names{synthetic::names(blocks)};
+  const std::string input{"[\n" +
+                          synthetic::click_events(blocks, k_batch_size)};
+  const unique_fd input_fd{memfd_create("click_events", MFD_CLOEXEC),
+                           "memfd_create"};
+  if (write(input_fd.get(), input.data(), input.size()) !=
+      static_cast<ssize_t>(input.size())) {
+    throw std::system_error{errno, std::generic_category(), "write()"};
+  }
+  i3bar_data::click_event click_event{};
+
+  for (std::size_t done{0}; done < state.iterations();) {
+    if (lseek(input_fd.get(), 0, SEEK_SET) == -1) {
+      throw std::system_error{errno, std::generic_category(), "lseek()"};
+    }
+    click_event_reader click_event_reader{input_fd.get(), names};
+    const std::size_t count{
+        std::min((state.iterations() - done), k_batch_size)};
+
+    state.start();
+    for (std::size_t i{0}; i < count; ++i) {
+      click_event_reader.read(click_event);
+      do_not_optimize(click_event);
+    }
+    state.stop();
+    done += count;
+  }
+}
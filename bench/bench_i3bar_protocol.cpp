@@ -0,0 +1,191 @@
+#include "benchmarks.hpp"
+
+#include "bench.hpp"
+#include "synthetic.hpp"
+
+#include "i3bar_data.hpp"
+#include "i3bar_protocol.hpp"
+#include "make_block.hpp"
+#include "metrics.hpp"
+#include "statusline_writer.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+void i3neostatus::bench::benchmarks::serialize_block(state &state) {
+  impl::serialize_block(state, true);
+}
+
+void i3neostatus::bench::benchmarks::serialize_block_unthemed(state &state) {
+  impl::serialize_block(state, false);
+}
+
+void i3neostatus::bench::benchmarks::serialize_string_markup(state &state) {
+  const std::string markup{synthetic::markup(synthetic::k_markup_size)};
+  std::string output{};
+
+  state.start();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    output.clear();
+    i3bar_protocol::impl::serialize_string(output, markup);
+    do_not_optimize(output);
+  }
+  state.stop();
+
+  state.set_counter(
+      "bytes_per_s",
+      (static_cast<double>(markup.size()) *
+       static_cast<double>(state.iterations()) /
+       std::chrono::duration<double>{state.elapsed()}.count()));
+}
+
+void i3neostatus::bench::benchmarks::print_statusline(state &state) {
+  impl::print_statusline(state, false);
+}
+
+void i3neostatus::bench::benchmarks::print_statusline_separators(
+    state &state) {
+  impl::print_statusline(state, true);
+}
+
+void i3neostatus::bench::benchmarks::print_statusline_pipe_40(state &state) {
+  impl::print_statusline_pipe(state, false);
+}
+
+void i3neostatus::bench::benchmarks::print_statusline_pipe_40_ostream(
+    state &state) {
+  impl::print_statusline_pipe(state, true);
+}
+
+void i3neostatus::bench::benchmarks::impl::serialize_block(state &state,
+                                                           const bool themed) {
+  metrics::init(synthetic::k_block_count);
+  const make_block::theme_table theme_table{synthetic::make_theme(), true};
+  std::vector<i3bar_data::block> blocks{
+      synthetic::blocks(theme_table, synthetic::k_block_count)};
+  if (!themed) {
+    for (i3bar_data::block &cur_block : blocks) {
+      cur_block.data.program.serialized = nullptr;
+    }
+  }
+  // reused like the entries of the main loop's string cache
+  std::string output{};
+
+  state.start();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    output.clear();
+    i3bar_protocol::impl::serialize_block(output, blocks[i % blocks.size()],
+                                          true);
+    do_not_optimize(output);
+  }
+  state.stop();
+}
+
+void i3neostatus::bench::benchmarks::impl::print_statusline(
+    state &state, const bool separators) {
+  metrics::init(synthetic::k_block_count);
+  const make_block::theme_table theme_table{synthetic::make_theme(),
+                                            separators};
+  const std::vector<i3bar_data::block> blocks{
+      synthetic::blocks(theme_table, synthetic::k_block_count)};
+  std::vector<std::string> content_cache{};
+  std::vector<std::string> separator_cache{};
+  if (separators) {
+    i3bar_protocol::update_statusline(
+        blocks, content_cache, synthetic::separators(theme_table, blocks),
+        separator_cache, true);
+  } else {
+    i3bar_protocol::update_statusline(blocks, content_cache, true);
+  }
+  // never stalls, the writev() is measured but not a terminal
+  const unique_fd null_fd{open("/dev/null", (O_WRONLY | O_CLOEXEC)), "open"};
+  statusline_writer statusline_writer{null_fd.get()};
+
+  state.start();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    if (separators) {
+      i3bar_protocol::print_statusline(content_cache, separator_cache, true,
+                                       statusline_writer);
+    } else {
+      i3bar_protocol::print_statusline(content_cache, true,
+                                       statusline_writer);
+    }
+  }
+  state.stop();
+}
+
+void i3neostatus::bench::benchmarks::impl::print_statusline_pipe(
+    state &state, const bool ostream) {
+  metrics::init(synthetic::k_large_block_count);
+  const make_block::theme_table theme_table{synthetic::make_theme(), true};
+  const std::vector<i3bar_data::block> blocks{
+      synthetic::blocks(theme_table, synthetic::k_large_block_count)};
+  std::vector<std::string> content_cache{};
+  std::vector<std::string> separator_cache{};
+  i3bar_protocol::update_statusline(
+      blocks, content_cache, synthetic::separators(theme_table, blocks),
+      separator_cache, true);
+  std::array<int, 2> fds{-1, -1};
+  if (pipe2(fds.data(), O_CLOEXEC) == -1) {
+    throw std::system_error{errno, std::generic_category(), "pipe2()"};
+  }
+  const unique_fd read_end{fds[0], "pipe2"};
+  // i3bar, declared before write_end so that it is joined after the write
+  // end is closed and it has read everything
+  const std::jthread drain_thread{[&read_end]() -> void {
+    std::array<char, 65536> buffer{};
+    while (true) {
+      const ssize_t count{read(read_end.get(), buffer.data(), buffer.size())};
+      if ((count == 0) || ((count == -1) && (errno != EINTR))) {
+        break;
+      }
+    }
+  }};
+  const unique_fd write_end{fds[1], "pipe2"};
+
+  if (ostream) {
+    // a blocking file description of its own, like std::cout before
+    std::ofstream stream{"/dev/fd/" + std::to_string(write_end.get()),
+                         std::ios::binary};
+    if (!stream.is_open()) {
+      throw std::system_error{errno, std::generic_category(), "open()"};
+    }
+
+    state.start();
+    for (std::size_t i{0}; i < state.iterations(); ++i) {
+      i3bar_protocol::impl::print_statusline(content_cache, separator_cache,
+                                             true, stream);
+    }
+    state.stop();
+  } else {
+    statusline_writer statusline_writer{write_end.get()};
+    pollfd output{.fd{write_end.get()}, .events{POLLOUT}, .revents{0}};
+
+    state.start();
+    for (std::size_t i{0}; i < state.iterations(); ++i) {
+      // every frame is written whole, where the main loop would drop the
+      // ones superseded during a stall
+      if (!i3bar_protocol::print_statusline(content_cache, separator_cache,
+                                            true, statusline_writer)) {
+        do {
+          if ((poll(&output, 1, -1) == -1) && (errno != EINTR)) {
+            throw std::system_error{errno, std::generic_category(),
+                                    "poll()"};
+          }
+        } while (!statusline_writer.flush());
+      }
+    }
+    state.stop();
+  }
+}
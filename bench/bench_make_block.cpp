@@ -0,0 +1,73 @@
+#include "benchmarks.hpp"
+
+#include "bench.hpp"
+#include "synthetic.hpp"
+
+#include "block_state.hpp"
+#include "i3bar_data.hpp"
+#include "make_block.hpp"
+#include "theme.hpp"
+
+#include <cstddef>
+#include <vector>
+
+void i3neostatus::bench::benchmarks::make_block_content(state &state) {
+  const theme::theme theme{synthetic::make_theme()};
+
+  state.start();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    const struct i3bar_data::block::data::program program{make_block::content(
+        theme,
+        static_cast<block_state>(i %
+                                 static_cast<std::size_t>(block_state::max)),
+        ((i % 2) != 0), true)};
+    do_not_optimize(program);
+  }
+  state.stop();
+}
+
+void i3neostatus::bench::benchmarks::make_block_separator(state &state) {
+  const theme::theme theme{synthetic::make_theme()};
+  const make_block::theme_table theme_table{theme, true};
+  const std::vector<i3bar_data::block> blocks{
+      synthetic::blocks(theme_table, synthetic::k_block_count)};
+
+  state.start();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    const i3bar_data::block separator{make_block::separator(
+        theme, &blocks[i % blocks.size()].data.program.theme,
+        &blocks[(i + 1) % blocks.size()].data.program.theme)};
+    do_not_optimize(separator);
+  }
+  state.stop();
+}
+
+void i3neostatus::bench::benchmarks::theme_table_content(state &state) {
+  const make_block::theme_table theme_table{synthetic::make_theme(), true};
+
+  state.start();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    const struct i3bar_data::block::data::program &program{
+        theme_table.content(
+            static_cast<block_state>(
+                i % static_cast<std::size_t>(block_state::max)),
+            ((i % 2) != 0))};
+    do_not_optimize(program);
+  }
+  state.stop();
+}
+
+void i3neostatus::bench::benchmarks::theme_table_separator(state &state) {
+  const make_block::theme_table theme_table{synthetic::make_theme(), true};
+  const std::vector<i3bar_data::block> blocks{
+      synthetic::blocks(theme_table, synthetic::k_block_count)};
+
+  state.start();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    const i3bar_data::block &separator{
+        theme_table.separator(&blocks[i % blocks.size()].data.program,
+                              &blocks[(i + 1) % blocks.size()].data.program)};
+    do_not_optimize(separator);
+  }
+  state.stop();
+}
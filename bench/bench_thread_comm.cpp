@@ -0,0 +1,80 @@
+#include "benchmarks.hpp"
+
+#include "bench.hpp"
+#include "synthetic.hpp"
+
+#include "plugin_api.hpp"
+#include "thread_comm.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <variant>
+#include <vector>
+
+void i3neostatus::bench::benchmarks::shared_state_put_get(state &state) {
+  impl::shared_state_put_get(state, 0);
+}
+
+void i3neostatus::bench::benchmarks::shared_state_history_put_get(
+    state &state) {
+  impl::shared_state_put_get(state, synthetic::k_history_depth);
+}
+
+void i3neostatus::bench::benchmarks::shared_state_threads(state &state) {
+  // a plugin thread putting every update in history mode, so that each one
+  // is passed on, and the main thread taking them
+  const std::vector<plugin_api::block> values{synthetic::plugin_blocks()};
+  thread_comm::shared_state_arena<plugin_api::block> arena{1};
+  thread_comm::producer<plugin_api::block> producer{
+      thread_comm::make<plugin_api::block, thread_comm::producer>(
+          arena, {nullptr, nullptr}, thread_comm::shared_state_state::null)};
+  thread_comm::consumer<plugin_api::block> consumer{
+      thread_comm::make_from<thread_comm::consumer>(producer)};
+  consumer.set_history(synthetic::k_history_depth, false);
+  std::atomic<bool> go{false};
+  std::thread plugin_thread{[&producer, &values, &go, &state]() -> void {
+    go.wait(false);
+    for (std::size_t i{0}; i < state.iterations(); ++i) {
+      while (!producer.put_value(values[i % values.size()])) {
+        std::this_thread::yield();
+      }
+    }
+  }};
+
+  state.start();
+  go.store(true);
+  go.notify_all();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    const std::variant<plugin_api::block, std::exception_ptr> value{
+        consumer.get()};
+    do_not_optimize(value);
+  }
+  state.stop();
+  plugin_thread.join();
+}
+
+void i3neostatus::bench::benchmarks::impl::shared_state_put_get(
+    state &state, const std::size_t history_depth) {
+  // the copying put of plugin_api::put_block()
+  const std::vector<plugin_api::block> values{synthetic::plugin_blocks()};
+  thread_comm::shared_state_arena<plugin_api::block> arena{1};
+  thread_comm::producer<plugin_api::block> producer{
+      thread_comm::make<plugin_api::block, thread_comm::producer>(
+          arena, {nullptr, nullptr}, thread_comm::shared_state_state::null)};
+  thread_comm::consumer<plugin_api::block> consumer{
+      thread_comm::make_from<thread_comm::consumer>(producer)};
+  if (history_depth != 0) {
+    consumer.set_history(history_depth, false);
+  }
+
+  state.start();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    producer.put_value(values[i % values.size()]);
+    const std::variant<plugin_api::block, std::exception_ptr> value{
+        consumer.get()};
+    do_not_optimize(value);
+  }
+  state.stop();
+}
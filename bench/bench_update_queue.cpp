@@ -0,0 +1,102 @@
+#include "benchmarks.hpp"
+
+#include "bench.hpp"
+#include "synthetic.hpp"
+
+#include "event_loop.hpp"
+#include "metrics.hpp"
+#include "plugin_id.hpp"
+#include "update_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <sys/epoll.h>
+
+void i3neostatus::bench::benchmarks::update_queue_put_get(state &state) {
+  // every put finds the queue empty, so this includes the eventfd write
+  // of a wakeup
+  update_queue update_queue{synthetic::k_block_count};
+
+  state.start();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    update_queue.put(i % synthetic::k_block_count);
+    const plugin_id::type id{update_queue.get()};
+    do_not_optimize(id);
+  }
+  state.stop();
+  update_queue.clear_notification();
+}
+
+void i3neostatus::bench::benchmarks::update_queue_threads(state &state) {
+  // one producer thread per plugin (--producers), each with at most one id
+  // queued (update_info::is_buffered), and the main loop waiting on the
+  // eventfd and draining the queue. put_ns is the time spent in put() by
+  // the producers, including one clock read
+  const std::size_t producer_count{state.producer_count()};
+  update_queue update_queue{producer_count};
+  event_loop event_loop{};
+  event_loop.add(update_queue.get_fd(), EPOLLIN, 0);
+  std::vector<update_queue::update_info> updates{};
+  updates.reserve(producer_count);
+  for (std::size_t i{0}; i < producer_count; ++i) {
+    updates.emplace_back(i, &update_queue);
+  }
+  std::atomic<bool> go{false};
+  std::atomic<std::uint64_t> put_ns{0};
+  std::vector<std::thread> producers{};
+  producers.reserve(producer_count);
+  for (std::size_t i{0}; i < producer_count; ++i) {
+    // the updates are split evenly between the producers
+    const std::size_t put_count{
+        (state.iterations() / producer_count) +
+        ((i < (state.iterations() % producer_count)) ? (1) : (0))};
+    producers.emplace_back([&cur_update = updates[i], &go, &put_ns,
+                            put_count]() -> void {
+      go.wait(false);
+      clock::duration put_time{clock::duration::zero()};
+      for (std::size_t j{0}; j < put_count; ++j) {
+        while (cur_update.is_buffered.exchange(true)) {
+          std::this_thread::yield();
+        }
+        const clock::time_point before{clock::now()};
+        cur_update.update_queue->put(cur_update.id);
+        put_time += (clock::now() - before);
+      }
+      put_ns.fetch_add(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(put_time)
+              .count(),
+          std::memory_order_relaxed);
+    });
+  }
+  const std::uint64_t wakeups_before{metrics::global.update_wakeups.load()};
+
+  state.start();
+  go.store(true);
+  go.notify_all();
+  for (std::size_t done{0}; done < state.iterations();) {
+    event_loop.wait();
+    // as in the main loop, cleared before draining
+    update_queue.clear_notification();
+    while (update_queue.count().load() != 0) {
+      updates[update_queue.get()].is_buffered.store(false);
+      ++done;
+    }
+  }
+  state.stop();
+
+  for (std::thread &cur_producer : producers) {
+    cur_producer.join();
+  }
+  state.set_counter("put_ns", (static_cast<double>(put_ns.load()) /
+                               static_cast<double>(state.iterations())));
+  state.set_counter(
+      "wakeups_per_update",
+      (static_cast<double>(metrics::global.update_wakeups.load() -
+                           wakeups_before) /
+       static_cast<double>(state.iterations())));
+}
@@ -0,0 +1,42 @@
+#include "benchmarks.hpp"
+
+#include "bench.hpp"
+
+#include "plugin_id.hpp"
+#include "visible_index.hpp"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+void i3neostatus::bench::benchmarks::visible_index_toggle(state &state) {
+  // what the main loop does when a block is hidden or shown: set/clear it,
+  // then look up its position (for the alternating tint) and its neighbours
+  // (for the separators on both sides)
+  static constexpr plugin_id::type k_plugin_count{500};
+  // a fixed seed, so that every run toggles the same plugins
+  std::minstd_rand random{1};
+  std::uniform_int_distribution<plugin_id::type> distribution{
+      0, (k_plugin_count - 1)};
+  std::vector<plugin_id::type> ids(4096);
+  for (plugin_id::type &cur_id : ids) {
+    cur_id = distribution(random);
+  }
+  visible_index visible_index{k_plugin_count};
+  for (plugin_id::type i{0}; i < k_plugin_count; i += 2) {
+    visible_index.set(i, true);
+  }
+
+  state.start();
+  for (std::size_t i{0}; i < state.iterations(); ++i) {
+    const plugin_id::type id{ids[i % ids.size()]};
+    visible_index.set(id, (!visible_index.is_visible(id)));
+    const plugin_id::type position{visible_index.position(id)};
+    const plugin_id::type previous{visible_index.previous(id)};
+    const plugin_id::type next{visible_index.next(id)};
+    do_not_optimize(position);
+    do_not_optimize(previous);
+    do_not_optimize(next);
+  }
+  state.stop();
+}
@@ -0,0 +1,62 @@
+#ifndef I3NEOSTATUS_BENCH_BENCHMARKS_HPP
+#define I3NEOSTATUS_BENCH_BENCHMARKS_HPP
+
+#include "bench.hpp"
+
+#include <cstddef>
+
+namespace i3neostatus {
+namespace bench {
+namespace benchmarks {
+// bench_i3bar_protocol.cpp, one operation is one block or one status line of
+// synthetic::k_block_count blocks. the _pipe_40 ones print
+// synthetic::k_large_block_count blocks with separators into a pipe drained
+// by another thread, with statusline_writer or (_ostream) with the
+// std::ostream and flush of before it. serialize_string_markup escapes
+// synthetic::k_markup_size bytes of Pango markup, and also reports bytes_per_s
+void serialize_block(state &state);
+void serialize_block_unthemed(state &state);
+void serialize_string_markup(state &state);
+void print_statusline(state &state);
+void print_statusline_separators(state &state);
+void print_statusline_pipe_40(state &state);
+void print_statusline_pipe_40_ostream(state &state);
+
+// bench_click_event_reader.cpp, one operation is one event
+void click_event_reader_read(state &state);
+
+// bench_update_queue.cpp, one operation is one id passed through.
+// update_queue_threads also reports put_ns (per put, on the producers) and
+// wakeups_per_update
+void update_queue_put_get(state &state);
+void update_queue_threads(state &state);
+
+// bench_thread_comm.cpp, one operation is one value passed through
+void shared_state_put_get(state &state);
+void shared_state_history_put_get(state &state);
+void shared_state_threads(state &state);
+
+// bench_make_block.cpp, one operation is one program part or separator.
+// theme_table is built with make_block::content() and separator() once, its
+// lookups are what re-theming a block costs at run time
+void make_block_content(state &state);
+void make_block_separator(state &state);
+void theme_table_content(state &state);
+void theme_table_separator(state &state);
+
+// bench_visible_index.cpp, one operation is one plugin of 500 hidden or
+// shown, with the position/previous/next lookups that follow it
+void visible_index_toggle(state &state);
+
+namespace impl {
+void serialize_block(state &state, const bool themed);
+void print_statusline(state &state, const bool separators);
+void print_statusline_pipe(state &state, const bool ostream);
+// latest-value-wins with a history_depth of 0
+void shared_state_put_get(state &state, const std::size_t history_depth);
+} // namespace impl
+} // namespace benchmarks
+} // namespace bench
+} // namespace i3neostatus
+
+#endif
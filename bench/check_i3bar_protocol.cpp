@@ -0,0 +1,47 @@
+#include "checks.hpp"
+
+#include "bench.hpp"
+#include "legacy_i3bar_protocol.hpp"
+#include "synthetic.hpp"
+
+#include "i3bar_data.hpp"
+#include "i3bar_protocol.hpp"
+#include "make_block.hpp"
+#include "metrics.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+i3neostatus::bench::check_result
+i3neostatus::bench::checks::serialize_block_legacy() {
+  static constexpr std::size_t k_block_count{20000};
+  metrics::init(k_block_count);
+  const make_block::theme_table theme_table{synthetic::make_theme(), true};
+  const std::vector<i3bar_data::block> blocks{
+      synthetic::random_blocks(theme_table, k_block_count)};
+
+  check_result ret_val{.cases{0}, .mismatches{0}};
+  std::string output{};
+  std::string legacy_output{};
+  for (const i3bar_data::block &cur_block : blocks) {
+    for (const bool hide_empty : {false, true}) {
+      output.clear();
+      legacy_output.clear();
+      i3bar_protocol::impl::serialize_block(output, cur_block, hide_empty);
+      legacy_i3bar_protocol::serialize_block(legacy_output, cur_block,
+                                             hide_empty);
+      ++ret_val.cases;
+      if (output != legacy_output) {
+        if (ret_val.mismatches == 0) {
+          std::cerr << "serialize_block_legacy: block " << cur_block.id.instance
+                    << ", hide_empty " << hide_empty << "\n  current: "
+                    << output << "\n  legacy:  " << legacy_output << std::endl;
+        }
+        ++ret_val.mismatches;
+      }
+    }
+  }
+  return ret_val;
+}
@@ -0,0 +1,70 @@
+#include "checks.hpp"
+
+#include "bench.hpp"
+
+#include "json_escape.hpp"
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+i3neostatus::bench::check_result
+i3neostatus::bench::checks::json_escape_find() {
+  static constexpr std::size_t k_string_count{20000};
+  // mostly characters that are copied as is, so that the vector versions
+  // scan whole chunks, with the ones that have to be escaped and their
+  // neighbours (0x1F/0x20, '"'-1/'"'+1, '\\'-1/'\\'+1) and bytes >= 0x80,
+  // which the unsigned comparison must not match
+  static constexpr std::string_view k_rare{"\x00\x01\x1f\x20!\"#[\\]\x7f",
+                                           11};
+
+  std::vector<std::pair<std::string_view, json_escape::impl::find_func>>
+      finds{{"find_scalar", &json_escape::impl::find_scalar}};
+#if defined(__x86_64__)
+  finds.emplace_back("find_sse2", &json_escape::impl::find_sse2);
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    finds.emplace_back("find_avx2", &json_escape::impl::find_avx2);
+  }
+#endif
+
+  std::minstd_rand random{1};
+  check_result ret_val{.cases{0}, .mismatches{0}};
+  std::string string{};
+  for (std::size_t i{0}; i < k_string_count; ++i) {
+    // up to a few vector widths, with the tails the vector loops hand on
+    string.resize(random() % 160);
+    const unsigned int rare_percent{static_cast<unsigned int>(random() % 8)};
+    for (char &cur_char : string) {
+      const unsigned int roll{static_cast<unsigned int>(random() % 100)};
+      cur_char =
+          ((roll < rare_percent)
+               ? (k_rare[random() % k_rare.size()])
+               : ((roll < 90) ? (static_cast<char>('a' + (random() % 26)))
+                              : (static_cast<char>(0x80 + (random() % 0x80)))));
+    }
+
+    // every start position, aligned or not
+    for (std::size_t pos{0}; pos <= string.size(); ++pos) {
+      const std::size_t expected{finds.front().second(string, pos)};
+      for (std::size_t j{1}; j < finds.size(); ++j) {
+        const std::size_t found{finds[j].second(string, pos)};
+        ++ret_val.cases;
+        if (found != expected) {
+          if (ret_val.mismatches == 0) {
+            std::cerr << "json_escape_find: " << finds[j].first << " found "
+                      << found << ", find_scalar " << expected
+                      << " (size " << string.size() << ", pos " << pos << ")"
+                      << std::endl;
+          }
+          ++ret_val.mismatches;
+        }
+      }
+    }
+  }
+  return ret_val;
+}
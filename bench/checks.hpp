@@ -0,0 +1,22 @@
+#ifndef I3NEOSTATUS_BENCH_CHECKS_HPP
+#define I3NEOSTATUS_BENCH_CHECKS_HPP
+
+#include "bench.hpp"
+
+namespace i3neostatus {
+namespace bench {
+namespace checks {
+// check_i3bar_protocol.cpp, one case is one of synthetic::random_blocks()
+// serialized with and without hide_empty, which has to be byte-identical to
+// legacy_i3bar_protocol::serialize_block()
+check_result serialize_block_legacy();
+
+// check_json_escape.cpp, one case is one call of a vector version of
+// json_escape::impl::find_scalar() (those the cpu supports) on a random
+// string, from every start position, which has to agree with it
+check_result json_escape_find();
+} // namespace checks
+} // namespace bench
+} // namespace i3neostatus
+
+#endif
@@ -0,0 +1,218 @@
+#include "legacy_i3bar_protocol.hpp"
+
+#include "hide_block.hpp"
+#include "i3bar_data.hpp"
+#include "i3bar_data_conversions.hpp"
+#include "i3bar_protocol.hpp"
+
+#include "libconfigfile/color.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using namespace i3neostatus::i3bar_protocol;
+
+std::string &i3neostatus::bench::legacy_i3bar_protocol::serialize_block(
+    std::string &output, const struct i3bar_data::block &block,
+    const bool hide_empty) {
+  if (hide_block::get(block) && hide_empty) {
+    output += hide_block::set<std::string>();
+  } else {
+    serialize_object(
+        output, [&block]() -> std::vector<std::pair<std::string, std::string>> {
+          std::vector<std::pair<std::string, std::string>> ret_val;
+
+          ret_val.emplace_back(json_strings::block::k_name, std::string{});
+          serialize_string(ret_val.back().second, block.id.name);
+
+          ret_val.emplace_back(json_strings::block::k_instance, std::string{});
+          serialize_string(ret_val.back().second,
+                           std::to_string(block.id.instance));
+
+          ret_val.emplace_back(json_strings::block::k_separator, std::string{});
+          serialize_bool(ret_val.back().second,
+                         block.data.program.global.separator);
+
+          ret_val.emplace_back(json_strings::block::k_separator_block_width,
+                               std::string{});
+          serialize_number(ret_val.back().second,
+                           block.data.program.global.separator_block_width);
+
+          ret_val.emplace_back(json_strings::block::k_color, std::string{});
+          serialize_string(
+              ret_val.back().second,
+              libconfigfile::color::to_string(block.data.program.theme.color));
+
+          ret_val.emplace_back(json_strings::block::k_background,
+                               std::string{});
+          serialize_string(ret_val.back().second,
+                           libconfigfile::color::to_string(
+                               block.data.program.theme.background));
+
+          ret_val.emplace_back(json_strings::block::k_border, std::string{});
+          serialize_string(
+              ret_val.back().second,
+              libconfigfile::color::to_string(block.data.program.theme.border));
+
+          ret_val.emplace_back(json_strings::block::k_border_top,
+                               std::string{});
+          serialize_number(ret_val.back().second,
+                           block.data.program.theme.border_top);
+
+          ret_val.emplace_back(json_strings::block::k_border_right,
+                               std::string{});
+          serialize_number(ret_val.back().second,
+                           block.data.program.theme.border_right);
+
+          ret_val.emplace_back(json_strings::block::k_border_bottom,
+                               std::string{});
+          serialize_number(ret_val.back().second,
+                           block.data.program.theme.border_bottom);
+
+          ret_val.emplace_back(json_strings::block::k_border_left,
+                               std::string{});
+          serialize_number(ret_val.back().second,
+                           block.data.program.theme.border_left);
+
+          ret_val.emplace_back(json_strings::block::k_full_text, std::string{});
+          serialize_string(ret_val.back().second, block.data.plugin.full_text);
+
+          if (block.data.plugin.short_text.has_value()) {
+            ret_val.emplace_back(json_strings::block::k_short_text,
+                                 std::string{});
+            serialize_string(ret_val.back().second,
+                             *block.data.plugin.short_text);
+          }
+
+          if (block.data.plugin.min_width.has_value()) {
+            ret_val.emplace_back(json_strings::block::k_min_width,
+                                 std::string{});
+            ((block.data.plugin.min_width->index() == 0)
+                 ? (serialize_number(ret_val.back().second,
+                                     std::get<0>(*block.data.plugin.min_width)))
+                 : (serialize_string(
+                       ret_val.back().second,
+                       std::get<1>(*block.data.plugin.min_width))));
+          }
+
+          if (block.data.plugin.align.has_value()) {
+            ret_val.emplace_back(json_strings::block::k_align, std::string{});
+            serialize_string(
+                ret_val.back().second,
+                i3bar_data::types::to_string(*block.data.plugin.align));
+          }
+
+          if (block.data.plugin.urgent.has_value()) {
+            ret_val.emplace_back(json_strings::block::k_urgent, std::string{});
+            serialize_bool(ret_val.back().second, *block.data.plugin.urgent);
+          }
+
+          if (block.data.plugin.markup.has_value()) {
+            ret_val.emplace_back(json_strings::block::k_markup, std::string{});
+            serialize_string(
+                ret_val.back().second,
+                i3bar_data::types::to_string(*block.data.plugin.markup));
+          }
+
+          return ret_val;
+        }());
+  }
+  return output;
+}
+
+std::string &
+i3neostatus::bench::legacy_i3bar_protocol::serialize_name_value(
+    std::string &output, const std::string &name, const std::string &value) {
+
+  output += json_constants::k_string_delimiter;
+  output += name;
+  output += json_constants::k_string_delimiter;
+  output += json_constants::k_name_value_separator;
+  output += value;
+  return output;
+}
+
+std::string &i3neostatus::bench::legacy_i3bar_protocol::serialize_object(
+    std::string &output,
+    const std::vector<std::pair<std::string, std::string>> &object) {
+  output += json_constants::k_object_opening_delimiter;
+
+  for (std::size_t i{0}; i < object.size(); ++i) {
+    if (i != 0) {
+      output += json_constants::k_element_separator;
+    }
+    serialize_name_value(output, object[i].first, object[i].second);
+  }
+
+  output += json_constants::k_object_closing_delimiter;
+
+  return output;
+}
+
+std::string &i3neostatus::bench::legacy_i3bar_protocol::serialize_string(
+    std::string &output, const std::string_view string) {
+  static const std::string k_control_chars{
+      0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
+      0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+      0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F};
+
+  static const std::unordered_map<char, std::string> k_control_char_codes{
+      {0x00, "u0000"}, {0x01, "u0001"}, {0x02, "u0002"}, {0x03, "u0003"},
+      {0x04, "u0004"}, {0x05, "u0005"}, {0x06, "u0006"}, {0x07, "u0007"},
+      {0x08, "u0008"}, {0x09, "u0009"}, {0x0A, "u000A"}, {0x0B, "u000B"},
+      {0x0C, "u000C"}, {0x0D, "u000D"}, {0x0E, "u000E"}, {0x0F, "u000F"},
+      {0x10, "u0010"}, {0x11, "u0011"}, {0x12, "u0012"}, {0x13, "u0013"},
+      {0x14, "u0014"}, {0x15, "u0015"}, {0x16, "u0016"}, {0x17, "u0017"},
+      {0x18, "u0018"}, {0x19, "u0019"}, {0x1A, "u001A"}, {0x1B, "u001B"},
+      {0x1C, "u001C"}, {0x1D, "u001D"}, {0x1E, "u001E"}, {0x1F, "u001F"}};
+
+  static const std::string k_need_to_replace{
+      k_control_chars + json_constants::k_string_delimiter +
+      json_constants::k_escape_leader};
+
+  // ret_val.reserve(string.size() + 2);
+
+  output += json_constants::k_string_delimiter;
+
+  std::string::size_type pos{0};
+  std::string::size_type pos_prev{0};
+  while (true) {
+    pos = string.find_first_of(k_need_to_replace, pos_prev);
+    if (pos == std::string::npos) {
+      break;
+    } else {
+      output += string.substr(pos_prev, (pos - pos_prev));
+      output += json_constants::k_escape_leader;
+
+      switch (string[pos]) {
+      case json_constants::k_string_delimiter: {
+        output += json_constants::k_string_delimiter;
+      } break;
+      case json_constants::k_escape_leader: {
+        output += json_constants::k_escape_leader;
+      } break;
+      default: {
+        output += k_control_char_codes.at(string[pos]);
+      } break;
+      }
+
+      pos_prev = pos + 1;
+    }
+  }
+  output += string.substr(pos_prev);
+
+  output += json_constants::k_string_delimiter;
+
+  return output;
+}
+
+std::string &i3neostatus::bench::legacy_i3bar_protocol::serialize_bool(
+    std::string &output, const bool b) {
+  output += ((b) ? ("true") : ("false"));
+  return output;
+}
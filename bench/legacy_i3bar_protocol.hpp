@@ -0,0 +1,42 @@
+#ifndef I3NEOSTATUS_BENCH_LEGACY_I3BAR_PROTOCOL_HPP
+#define I3NEOSTATUS_BENCH_LEGACY_I3BAR_PROTOCOL_HPP
+
+#include "i3bar_data.hpp"
+
+#include <concepts>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace i3neostatus {
+namespace bench {
+// i3bar_protocol::impl::serialize_block() as it was before the compile-time
+// field table, with t_output fixed to std::string. the current serializer
+// has to write the same bytes (see check_i3bar_protocol.cpp)
+namespace legacy_i3bar_protocol {
+std::string &serialize_block(std::string &output,
+                             const struct i3bar_data::block &block,
+                             const bool hide_empty);
+
+std::string &serialize_name_value(std::string &output,
+                                  const std::string &name,
+                                  const std::string &value);
+std::string &serialize_object(
+    std::string &output,
+    const std::vector<std::pair<std::string, std::string>> &object);
+std::string &serialize_number(std::string &output, auto number)
+  requires(std::integral<decltype(number)> ||
+           std::floating_point<decltype(number)>)
+{
+  output += std::to_string(number);
+  return output;
+}
+std::string &serialize_string(std::string &output,
+                              const std::string_view string);
+std::string &serialize_bool(std::string &output, const bool b);
+} // namespace legacy_i3bar_protocol
+} // namespace bench
+} // namespace i3neostatus
+
+#endif
@@ -0,0 +1,143 @@
+#include "bench.hpp"
+#include "benchmarks.hpp"
+#include "checks.hpp"
+
+#include "bits-and-bytes/constexpr_hash_string.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace i3neostatus;
+
+static constexpr std::array k_benchmarks{
+    bench::benchmark{"serialize_block", bench::benchmarks::serialize_block},
+    bench::benchmark{"serialize_block_unthemed",
+                     bench::benchmarks::serialize_block_unthemed},
+    bench::benchmark{"serialize_string_markup",
+                     bench::benchmarks::serialize_string_markup},
+    bench::benchmark{"print_statusline", bench::benchmarks::print_statusline},
+    bench::benchmark{"print_statusline_separators",
+                     bench::benchmarks::print_statusline_separators},
+    bench::benchmark{"print_statusline_pipe_40",
+                     bench::benchmarks::print_statusline_pipe_40},
+    bench::benchmark{"print_statusline_pipe_40_ostream",
+                     bench::benchmarks::print_statusline_pipe_40_ostream},
+    bench::benchmark{"click_event_reader_read",
+                     bench::benchmarks::click_event_reader_read},
+    bench::benchmark{"update_queue_put_get",
+                     bench::benchmarks::update_queue_put_get},
+    bench::benchmark{"update_queue_threads",
+                     bench::benchmarks::update_queue_threads},
+    bench::benchmark{"shared_state_put_get",
+                     bench::benchmarks::shared_state_put_get},
+    bench::benchmark{"shared_state_history_put_get",
+                     bench::benchmarks::shared_state_history_put_get},
+    bench::benchmark{"shared_state_threads",
+                     bench::benchmarks::shared_state_threads},
+    bench::benchmark{"make_block_content",
+                     bench::benchmarks::make_block_content},
+    bench::benchmark{"make_block_separator",
+                     bench::benchmarks::make_block_separator},
+    bench::benchmark{"theme_table_content",
+                     bench::benchmarks::theme_table_content},
+    bench::benchmark{"theme_table_separator",
+                     bench::benchmarks::theme_table_separator},
+    bench::benchmark{"visible_index_toggle",
+                     bench::benchmarks::visible_index_toggle},
+};
+
+static constexpr std::array k_checks{
+    bench::check{"serialize_block_legacy",
+                 bench::checks::serialize_block_legacy},
+    bench::check{"json_escape_find", bench::checks::json_escape_find},
+};
+
+// usage: i3neostatus_bench [-t|--min-time MILLISECONDS]
+//                          [-p|--producers COUNT] [-c|--check] [FILTER...]
+// runs the benchmarks (or with --check, the checks) whose name contains any
+// FILTER (all without one). a check that finds a mismatch fails the run
+int main(int argc, char *argv[]) {
+  try {
+    bench::settings settings{};
+    bool check{false};
+    std::vector<std::string_view> filters{};
+
+    for (int cur_arg{1}; cur_arg < argc; ++cur_arg) {
+      switch (bits_and_bytes::constexpr_hash_string::hash(argv[cur_arg])) {
+      case bits_and_bytes::constexpr_hash_string::hash("-t"):
+      case bits_and_bytes::constexpr_hash_string::hash("--min-time"): {
+        if ((cur_arg + 1) < argc) {
+          settings.min_time =
+              std::chrono::milliseconds{std::stol(argv[++cur_arg])};
+        } else {
+          std::cerr << '"' << argv[cur_arg] << "\" option requires an argument"
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      } break;
+      case bits_and_bytes::constexpr_hash_string::hash("-p"):
+      case bits_and_bytes::constexpr_hash_string::hash("--producers"): {
+        if ((cur_arg + 1) < argc) {
+          settings.producer_count =
+              std::max(std::stoul(argv[++cur_arg]), 1UL);
+        } else {
+          std::cerr << '"' << argv[cur_arg] << "\" option requires an argument"
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      } break;
+      case bits_and_bytes::constexpr_hash_string::hash("-c"):
+      case bits_and_bytes::constexpr_hash_string::hash("--check"): {
+        check = true;
+      } break;
+      default: {
+        if (*argv[cur_arg] == '-') {
+          std::cerr << '"' << argv[cur_arg] << "\" option is unrecognized"
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+        filters.emplace_back(argv[cur_arg]);
+      } break;
+      }
+    }
+
+    const auto selected{[&filters](const std::string_view name) -> bool {
+      return (filters.empty() ||
+              std::ranges::any_of(filters,
+                                  [name](const std::string_view filter) {
+                                    return (name.find(filter) !=
+                                            std::string_view::npos);
+                                  }));
+    }};
+
+    if (check) {
+      bool passed{true};
+      for (const bench::check &cur_check : k_checks) {
+        if (selected(cur_check.name)) {
+          const bench::check_result result{cur_check.run()};
+          bench::print_result(std::cout, cur_check, result);
+          passed = (passed && (result.mismatches == 0));
+        }
+      }
+      return ((passed) ? (EXIT_SUCCESS) : (EXIT_FAILURE));
+    }
+
+    for (const bench::benchmark &cur_benchmark : k_benchmarks) {
+      if (selected(cur_benchmark.name)) {
+        bench::print_result(std::cout, cur_benchmark,
+                            bench::run(cur_benchmark, settings));
+      }
+    }
+    return EXIT_SUCCESS;
+  } catch (const std::exception &error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,213 @@
+#include "synthetic.hpp"
+
+#include "block_state.hpp"
+#include "hide_block.hpp"
+#include "i3bar_data.hpp"
+#include "make_block.hpp"
+#include "plugin_api.hpp"
+#include "theme.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+i3neostatus::theme::theme i3neostatus::bench::synthetic::make_theme() {
+  theme::theme ret_val{theme::k_default};
+  ret_val.alternating_tint_color_background = {{0x10, 0x10, 0x10}, 0x00};
+  ret_val.separator_begin_sequence = "[";
+  ret_val.separator_end_sequence = "]";
+  return ret_val;
+}
+
+std::vector<i3neostatus::i3bar_data::block>
+i3neostatus::bench::synthetic::blocks(
+    const make_block::theme_table &theme_table, const std::size_t count) {
+  static constexpr std::array<std::string_view, 4> k_names{
+      "cpu", "memory", "network", "date_time"};
+  static constexpr std::array<std::string_view, 4> k_full_texts{
+      "CPU 12%", "MEM 3.2 GiB / 15.5 GiB",
+      "wlan0: 192.168.178.23 (84% at home_network) 54 Mbit/s",
+      "2024-05-17 ä 13:37:42"};
+
+  std::vector<i3bar_data::block> ret_val{};
+  ret_val.reserve(count);
+  for (std::size_t i{0}; i < count; ++i) {
+    const block_state state{static_cast<block_state>(
+        i % static_cast<std::size_t>(block_state::max))};
+    i3bar_data::block block{
+        .id{.name{std::string{k_names[i % k_names.size()]}}, .instance{i}},
+        .data{.program{theme_table.content(state, ((i % 2) != 0))},
+              .plugin{.full_text{
+                  std::string{k_full_texts[i % k_full_texts.size()]}}}}};
+    if ((i % 2) == 0) {
+      block.data.plugin.short_text = block.data.plugin.full_text.substr(0, 3);
+    }
+    if ((i % 3) == 0) {
+      block.data.plugin.min_width = 120;
+      block.data.plugin.align = i3bar_data::types::text_align::center;
+    }
+    if (state == block_state::critical) {
+      block.data.plugin.urgent = true;
+    }
+    ret_val.push_back(std::move(block));
+  }
+  return ret_val;
+}
+
+std::vector<i3neostatus::i3bar_data::block>
+i3neostatus::bench::synthetic::random_blocks(
+    const make_block::theme_table &theme_table, const std::size_t count) {
+  // well-formed UTF-8 only, serialize_text() replaces anything else
+  static constexpr std::array<std::string_view, 20> k_pieces{
+      "a", "Z", "0", " ", "\"", "\\", "\n", "\t", "\x01", "\x1f", "\x7f", "/",
+      "<b>", "</b>", "&amp;", "{\"x\":1}", "wlan0",
+      // two to four bytes long
+      "\xc3\xa4", "\xe2\x82\xac", "\xf0\x9d\x84\x9e"};
+
+  std::minstd_rand random{1};
+  const auto chance{[&random](const unsigned int percent) -> bool {
+    return ((random() % 100) < percent);
+  }};
+  const auto text{[&random, &chance]() -> std::string {
+    if (chance(5)) {
+      return hide_block::set<std::string>();
+    }
+    std::string ret_val{};
+    for (std::size_t i{random() % 24}; i > 0; --i) {
+      ret_val += k_pieces[random() % k_pieces.size()];
+    }
+    return ret_val;
+  }};
+  const auto number{[&random]() -> i3bar_data::types::pixel_count_t {
+    return static_cast<i3bar_data::types::pixel_count_t>(random() % 2000);
+  }};
+  const auto color{[&random]() -> i3bar_data::types::color {
+    const auto component{[&random]() -> std::uint8_t {
+      return static_cast<std::uint8_t>(random());
+    }};
+    return {{component(), component(), component()}, component()};
+  }};
+
+  std::vector<i3bar_data::block> ret_val{};
+  ret_val.reserve(count);
+  for (std::size_t i{0}; i < count; ++i) {
+    i3bar_data::block block{.id{.name{text()}, .instance{i}}};
+    if ((i % 2) == 0) {
+      block.data.program = theme_table.content(
+          static_cast<block_state>(random() %
+                                   static_cast<std::size_t>(block_state::max)),
+          chance(50));
+    } else {
+      block.data.program = {
+          .global{.separator{chance(50)}, .separator_block_width{number()}},
+          .theme{.color{color()},
+                 .background{color()},
+                 .border{color()},
+                 .border_top{number()},
+                 .border_right{number()},
+                 .border_bottom{number()},
+                 .border_left{number()}}};
+    }
+    block.data.plugin.full_text = text();
+    if (chance(50)) {
+      block.data.plugin.short_text = text();
+    }
+    if (chance(50)) {
+      if (chance(50)) {
+        block.data.plugin.min_width = number();
+      } else {
+        block.data.plugin.min_width = text();
+      }
+    }
+    if (chance(50)) {
+      block.data.plugin.align = static_cast<i3bar_data::types::text_align>(
+          random() %
+          static_cast<std::size_t>(i3bar_data::types::text_align::max));
+    }
+    if (chance(50)) {
+      block.data.plugin.urgent = chance(50);
+    }
+    if (chance(50)) {
+      block.data.plugin.markup = static_cast<i3bar_data::types::markup>(
+          random() % static_cast<std::size_t>(i3bar_data::types::markup::max));
+    }
+    ret_val.push_back(std::move(block));
+  }
+  return ret_val;
+}
+
+std::string i3neostatus::bench::synthetic::markup(const std::size_t size) {
+  static constexpr std::string_view k_markup{
+      "<span foreground=\"#A3BE8C\" weight=\"bold\">CPU</span> 12% "
+      "<span foreground=\"#EBCB8B\">MEM</span> 3.2 GiB / 15.5 GiB "
+      "<i>wlan0</i> 192.168.178.23 &amp; <b>84%</b> "
+      "<span font_family=\"monospace\">2024-05-17 ä 13:37:42</span> | "};
+
+  std::string ret_val{};
+  ret_val.reserve(size + k_markup.size());
+  while (ret_val.size() < size) {
+    ret_val += k_markup;
+  }
+  return ret_val;
+}
+
+std::vector<i3neostatus::i3bar_data::block>
+i3neostatus::bench::synthetic::separators(
+    const make_block::theme_table &theme_table,
+    const std::vector<i3bar_data::block> &blocks) {
+  std::vector<i3bar_data::block> ret_val{};
+  ret_val.reserve(blocks.size() + 1);
+  for (std::size_t i{0}; i <= blocks.size(); ++i) {
+    ret_val.push_back(theme_table.separator(
+        ((i > 0) ? (&blocks[i - 1].data.program) : (nullptr)),
+        ((i < blocks.size()) ? (&blocks[i].data.program) : (nullptr))));
+  }
+  return ret_val;
+}
+
+std::vector<i3neostatus::plugin_api::block>
+i3neostatus::bench::synthetic::plugin_blocks() {
+  const make_block::theme_table theme_table{make_theme(), false};
+  std::vector<plugin_api::block> ret_val{};
+  ret_val.reserve(k_block_count);
+  for (i3bar_data::block &cur_block : blocks(theme_table, k_block_count)) {
+    ret_val.emplace_back(std::move(cur_block.data.plugin), block_state::info);
+  }
+  return ret_val;
+}
+
+std::vector<std::string> i3neostatus::bench::synthetic::names(
+    const std::vector<i3bar_data::block> &blocks) {
+  std::vector<std::string> ret_val{};
+  ret_val.reserve(blocks.size());
+  for (const i3bar_data::block &cur_block : blocks) {
+    ret_val.push_back(cur_block.id.name);
+  }
+  return ret_val;
+}
+
+std::string i3neostatus::bench::synthetic::click_events(
+    const std::vector<i3bar_data::block> &blocks, const std::size_t count) {
+  std::string ret_val{};
+  for (std::size_t i{0}; i < count; ++i) {
+    const i3bar_data::block &block{blocks[i % blocks.size()]};
+    const std::string x{std::to_string(1200 + (i % 700))};
+    if (i != 0) {
+      ret_val += ",\n";
+    }
+    ret_val += "{\"name\":\"" + block.id.name + "\",\"instance\":\"" +
+               std::to_string(block.id.instance) + "\",\"button\":" +
+               std::to_string(1 + (i % 5)) + ",\"modifiers\":[" +
+               (((i % 4) == 0) ? ("\"Shift\",\"Mod4\"") : ("")) +
+               "],\"x\":" + x + ",\"y\":1060,\"relative_x\":" +
+               std::to_string(i % 97) +
+               ",\"relative_y\":11,\"output_x\":" + x +
+               ",\"output_y\":12,\"width\":97,\"height\":22}";
+  }
+  return ret_val;
+}
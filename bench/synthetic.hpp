@@ -0,0 +1,63 @@
+#ifndef I3NEOSTATUS_BENCH_SYNTHETIC_HPP
+#define I3NEOSTATUS_BENCH_SYNTHETIC_HPP
+
+#include "i3bar_data.hpp"
+#include "make_block.hpp"
+#include "plugin_api.hpp"
+#include "theme.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace i3neostatus {
+namespace bench {
+// data shaped like a typical status line, the same for every run so that
+// results can be compared between commits
+namespace synthetic {
+static constexpr std::size_t k_block_count{16};
+// a long status line, several KiB per frame with separators
+static constexpr std::size_t k_large_block_count{40};
+// a long Pango markup full_text
+static constexpr std::size_t k_markup_size{4096};
+// for the history mode of thread_comm::shared_state
+static constexpr std::size_t k_history_depth{16};
+
+// the default theme with begin/end separators and an alternating tint, so
+// that every part of a themed block is present
+theme::theme make_theme();
+
+// blocks cycle through the block states and differ in length and in which
+// optional members they have, themed like the main loop does it
+std::vector<i3bar_data::block>
+blocks(const make_block::theme_table &theme_table, const std::size_t count);
+// blocks with every optional member present or absent at random, random
+// numbers, and text with characters that have to be escaped and multi-byte
+// UTF-8 (and now and then the hidden block's). every second one is themed
+// through theme_table, the others have random colors and no serialized
+// program part. the seed is fixed, so every run generates the same blocks
+std::vector<i3bar_data::block>
+random_blocks(const make_block::theme_table &theme_table,
+              const std::size_t count);
+// at least size bytes of Pango markup, as a plugin with markup = pango puts
+// it in full_text, with the quoted attribute values that have to be escaped
+std::string markup(const std::size_t size);
+// one before, between and after blocks
+std::vector<i3bar_data::block>
+separators(const make_block::theme_table &theme_table,
+           const std::vector<i3bar_data::block> &blocks);
+
+// the plugin parts of blocks(), as put by a plugin
+std::vector<plugin_api::block> plugin_blocks();
+
+// names of blocks, for click_event_reader
+std::vector<std::string> names(const std::vector<i3bar_data::block> &blocks);
+// count click event objects on blocks as i3bar sends them (without the
+// opening bracket), some of them with modifiers
+std::string click_events(const std::vector<i3bar_data::block> &blocks,
+                         const std::size_t count);
+} // namespace synthetic
+} // namespace bench
+} // namespace i3neostatus
+
+#endif
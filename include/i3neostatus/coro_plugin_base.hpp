@@ -0,0 +1 @@
+../../src/coro_plugin_base.hpp
\ No newline at end of file
@@ -0,0 +1 @@
+../../src/poll_plugin_base.hpp
\ No newline at end of file
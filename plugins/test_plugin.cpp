@@ -10,6 +10,7 @@
 #include <condition_variable>
 #include <ctime>
 #include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
 
@@ -35,13 +36,21 @@ private:
   std::atomic<i3ns::state> m_state;
   std::atomic<bool> m_hidden;
   action m_action;
+  bool m_paused;
   std::mutex m_action_mtx;
   std::condition_variable m_action_cv;
+  // the one second timer only exists while run() is running and the plugin
+  // is not paused. not guarded by m_action_mtx, which the timer callback
+  // takes and cancel_timer() waits for
+  bool m_timer_enabled;
+  std::optional<i3ns::api::timer_id> m_timer;
+  std::mutex m_timer_mtx;
 
 public:
   test_plugin()
       : m_api{}, m_format{}, m_state{i3ns::state::good}, m_hidden{false},
-        m_action{action::cont}, m_action_mtx{}, m_action_cv{} {}
+        m_action{action::cont}, m_paused{false}, m_action_mtx{},
+        m_action_cv{}, m_timer_enabled{false}, m_timer{}, m_timer_mtx{} {}
 
   virtual ~test_plugin() {}
 
@@ -64,12 +73,13 @@ public:
   }
 
   virtual void run() override {
-    auto get_next_whole_second{[]() -> std::chrono::system_clock::time_point {
-      return std::chrono::system_clock::time_point{
-          std::chrono::duration_cast<std::chrono::seconds>(
-              std::chrono::system_clock::now().time_since_epoch()) +
-          std::chrono::seconds{1}};
-    }};
+    {
+      std::lock_guard<std::mutex> lock_m_action_mtx{m_action_mtx};
+      if (m_action == action::cont) {
+        m_action = action::wait;
+      }
+    }
+    set_timer_enabled(true);
 
     std::size_t buf_size{128};
     char *buf{nullptr};
@@ -109,16 +119,17 @@ public:
       }
 
       std::unique_lock<std::mutex> lock_m_action_mtx{m_action_mtx};
-      m_action = action::wait;
-      m_action_cv.wait_until(
-          lock_m_action_mtx, get_next_whole_second(),
-          [this]() -> bool { return m_action != action::wait; });
+      m_action_cv.wait(lock_m_action_mtx, [this]() -> bool {
+        return ((m_action == action::stop) ||
+                ((m_action == action::cont) && (!m_paused)));
+      });
       if (m_action == action::stop) {
         break;
       } else {
-        m_action = action::cont;
+        m_action = action::wait;
       }
     }
+    set_timer_enabled(false);
     free(buf);
   }
 
@@ -130,6 +141,25 @@ public:
     m_action_cv.notify_all();
   }
 
+  virtual void on_stop() override {
+    {
+      std::lock_guard<std::mutex> lock_m_action_mtx{m_action_mtx};
+      m_paused = true;
+    }
+    // nothing wakes the host while the bar is hidden
+    update_timer();
+  }
+
+  virtual void on_cont() override {
+    {
+      std::lock_guard<std::mutex> lock_m_action_mtx{m_action_mtx};
+      m_paused = false;
+      m_action = action::cont;
+    }
+    update_timer();
+    m_action_cv.notify_all();
+  }
+
   virtual void on_click_event(i3ns::click_event &&click_event) override {
     if ((click_event.modifiers & i3ns::types::click_modifiers::shift) !=
         i3ns::types::click_modifiers::none) {
@@ -147,6 +177,39 @@ public:
     }
     m_action_cv.notify_all();
   }
+
+private:
+  void set_timer_enabled(const bool enabled) {
+    {
+      std::lock_guard<std::mutex> lock_m_timer_mtx{m_timer_mtx};
+      m_timer_enabled = enabled;
+    }
+    update_timer();
+  }
+
+  void update_timer() {
+    std::lock_guard<std::mutex> lock_m_timer_mtx{m_timer_mtx};
+    bool paused;
+    {
+      std::lock_guard<std::mutex> lock_m_action_mtx{m_action_mtx};
+      paused = m_paused;
+    }
+    if (m_timer_enabled && (!paused) && (!m_timer)) {
+      // woken on every whole second together with every other plugin
+      m_timer = m_api->every(std::chrono::seconds{1}, [this]() -> void {
+        {
+          std::lock_guard<std::mutex> lock_m_action_mtx{m_action_mtx};
+          if (m_action == action::wait) {
+            m_action = action::cont;
+          }
+        }
+        m_action_cv.notify_all();
+      });
+    } else if (((!m_timer_enabled) || paused) && m_timer) {
+      m_api->cancel_timer(*m_timer);
+      m_timer.reset();
+    }
+  }
 };
 
 I3NEOSTATUS_PLUGIN_FACTORY_DEFINE(test_plugin);
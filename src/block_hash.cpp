@@ -0,0 +1,17 @@
+#include "block_hash.hpp"
+
+#include "plugin_api.hpp"
+
+#include <cstddef>
+
+std::size_t i3neostatus::block_hash::get(const plugin_api::block &block) {
+  std::size_t seed{0};
+  impl::combine(seed, block.first.full_text);
+  impl::combine(seed, block.first.short_text);
+  impl::combine(seed, block.first.min_width);
+  impl::combine(seed, block.first.align);
+  impl::combine(seed, block.first.urgent);
+  impl::combine(seed, block.first.markup);
+  impl::combine(seed, block.second);
+  return seed;
+}
@@ -0,0 +1,25 @@
+#ifndef I3NEOSTATUS_BLOCK_HASH_HPP
+#define I3NEOSTATUS_BLOCK_HASH_HPP
+
+#include "plugin_api.hpp"
+
+#include <cstddef>
+#include <functional>
+
+namespace i3neostatus {
+namespace block_hash {
+// only used to cheaply reject blocks that changed, equal hashes still have to
+// be confirmed by comparing the blocks
+std::size_t get(const plugin_api::block &block);
+
+namespace impl {
+template <typename t_value>
+void combine(std::size_t &seed, const t_value &value) {
+  seed ^= (std::hash<t_value>{}(value) + 0x9e3779b97f4a7c15 + (seed << 6) +
+           (seed >> 2));
+}
+} // namespace impl
+} // namespace block_hash
+} // namespace i3neostatus
+
+#endif
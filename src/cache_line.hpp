@@ -0,0 +1,13 @@
+#ifndef I3NEOSTATUS_CACHE_LINE_HPP
+#define I3NEOSTATUS_CACHE_LINE_HPP
+
+#include <cstddef>
+
+namespace i3neostatus {
+namespace cache_line {
+// std::hardware_destructive_interference_size is not reliably available
+static constexpr std::size_t k_size{64};
+} // namespace cache_line
+} // namespace i3neostatus
+
+#endif
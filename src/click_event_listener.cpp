@@ -1,27 +1,29 @@
 #include "click_event_listener.hpp"
 
+#include "click_event_reader.hpp"
 #include "i3bar_data.hpp"
-#include "i3bar_protocol.hpp"
+#include "metrics.hpp"
 #include "plugin_handle.hpp"
 #include "plugin_id.hpp"
 
-#include <istream>
+#include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
 i3neostatus::click_event_listener::click_event_listener(
     std::vector<plugin_handle> *plugin_handles,
-    std::istream *input_stream /*= &std::cin*/)
-    : m_plugin_handles{plugin_handles}, m_input_stream{input_stream},
+    const int input_fd /*= STDIN_FILENO*/)
+    : m_plugin_handles{plugin_handles}, m_input_fd{input_fd},
       m_thread{} {}
 
 i3neostatus::click_event_listener::click_event_listener(
     click_event_listener &&other) noexcept
     : m_plugin_handles{other.m_plugin_handles},
-      m_input_stream{other.m_input_stream},
+      m_input_fd{other.m_input_fd},
       m_thread{std::move(other.m_thread)} {
   other.m_plugin_handles = nullptr;
-  other.m_input_stream = nullptr;
+  other.m_input_fd = -1;
 }
 
 i3neostatus::click_event_listener::~click_event_listener() {
@@ -34,25 +36,37 @@ i3neostatus::click_event_listener &i3neostatus::click_event_listener::operator=(
     click_event_listener &&other) noexcept {
   if (this != &other) {
     m_plugin_handles = other.m_plugin_handles;
-    m_input_stream = other.m_input_stream;
+    m_input_fd = other.m_input_fd;
     m_thread = std::move(other.m_thread);
 
     other.m_plugin_handles = nullptr;
-    other.m_input_stream = nullptr;
+    other.m_input_fd = -1;
   }
   return *this;
 }
 
 void i3neostatus::click_event_listener::run() {
   m_thread = std::thread{[this]() -> void {
-    i3bar_protocol::init_click_event(*m_input_stream);
+    // the block names as they were sent, for the reader to intern
+    std::vector<std::string> names{};
+    names.reserve(m_plugin_handles->size());
+    for (const plugin_handle &cur_plugin_handle : *m_plugin_handles) {
+      names.push_back(std::visit(
+          [](auto &&path_or_name) {
+            return static_cast<std::string>(path_or_name);
+          },
+          cur_plugin_handle.get_path_or_name()));
+    }
+    click_event_reader click_event_reader{m_input_fd, names};
 
-    while (true) {
-      i3bar_data::click_event click_event{
-          i3bar_protocol::read_click_event(*m_input_stream)};
-      if (click_event.id.instance != plugin_id::null) {
+    i3bar_data::click_event click_event{};
+    while (click_event_reader.read(click_event)) {
+      if (click_event.id.instance < m_plugin_handles->size()) {
+        metrics::click_read(click_event.id.instance);
+        // copied, click_event is reused for the next event
+        struct i3bar_data::click_event::data data{click_event.data};
         (*m_plugin_handles)[click_event.id.instance].send_click_event(
-            std::move(click_event.data));
+            std::move(data));
       }
     }
   }};
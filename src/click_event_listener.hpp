@@ -3,20 +3,22 @@
 
 #include "plugin_handle.hpp"
 
-#include <istream>
+#include <thread>
 #include <vector>
 
+#include <unistd.h>
+
 namespace i3neostatus {
 
 class click_event_listener {
 private:
   std::vector<plugin_handle> *m_plugin_handles;
-  std::istream *m_input_stream;
+  int m_input_fd;
   std::thread m_thread;
 
 public:
   click_event_listener(std::vector<plugin_handle> *plugin_handles,
-                       std::istream *input_stream = &std::cin);
+                       const int input_fd = STDIN_FILENO);
 
   click_event_listener(click_event_listener &&other) noexcept;
 
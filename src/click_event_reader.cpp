@@ -0,0 +1,447 @@
+#include "click_event_reader.hpp"
+
+#include "i3bar_data.hpp"
+#include "i3bar_data_conversions.hpp"
+#include "i3bar_protocol.hpp"
+#include "plugin_id.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace json_constants = i3neostatus::i3bar_protocol::json_constants;
+
+i3neostatus::click_event_reader::click_event_reader(
+    const int fd, const std::vector<std::string> &names)
+    : m_fd{fd}, m_buffer{}, m_pos{0}, m_end{0}, m_in_array{false},
+      m_string{}, m_string_size{0}, m_number{},
+      m_names{names.begin(), names.end()} {}
+
+i3neostatus::click_event_reader::~click_event_reader() {}
+
+bool i3neostatus::click_event_reader::read(
+    i3bar_data::click_event &click_event) {
+  while (true) {
+    skip_whitespace();
+    const int c{peek()};
+    if (c == m_k_eof) {
+      return false;
+    } else if ((c == json_constants::k_array_opening_delimiter) &&
+               (!m_in_array)) {
+      get();
+      m_in_array = true;
+    } else if (c == json_constants::k_object_opening_delimiter) {
+      if (read_object(click_event)) {
+        return true;
+      }
+      // the rest of a malformed object is skipped like anything else
+      // between two objects, up to the next opening brace
+      if (peek() != json_constants::k_object_opening_delimiter) {
+        get();
+      }
+    } else {
+      // the comma before every event but the first
+      get();
+    }
+  }
+}
+
+int i3neostatus::click_event_reader::peek() {
+  while (m_pos == m_end) {
+    const ssize_t count{::read(m_fd, m_buffer.data(), m_buffer.size())};
+    if (count > 0) {
+      m_pos = 0;
+      m_end = static_cast<std::size_t>(count);
+    } else if (count == 0) {
+      return m_k_eof;
+    } else if (errno != EINTR) {
+      throw std::system_error{errno, std::generic_category(), "read()"};
+    }
+  }
+  return static_cast<unsigned char>(m_buffer[m_pos]);
+}
+
+int i3neostatus::click_event_reader::get() {
+  const int c{peek()};
+  if (c != m_k_eof) {
+    ++m_pos;
+  }
+  return c;
+}
+
+void i3neostatus::click_event_reader::skip_whitespace() {
+  while (true) {
+    switch (peek()) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r': {
+      get();
+    } break;
+    default: {
+      return;
+    } break;
+    }
+  }
+}
+
+bool i3neostatus::click_event_reader::expect(const char c) {
+  if (peek() != static_cast<unsigned char>(c)) {
+    return false;
+  }
+  get();
+  return true;
+}
+
+bool i3neostatus::click_event_reader::read_object(
+    i3bar_data::click_event &click_event) {
+  namespace keys = i3bar_protocol::json_strings::click_event;
+  using data_t = struct i3bar_data::click_event::data;
+  using pixel_count_t = i3bar_data::types::pixel_count_t;
+
+  static const std::array<std::pair<std::string_view, pixel_count_t data_t::*>,
+                          8>
+      k_pixel_count_fields{{{keys::k_x, &data_t::x},
+                            {keys::k_y, &data_t::y},
+                            {keys::k_relative_x, &data_t::relative_x},
+                            {keys::k_relative_y, &data_t::relative_y},
+                            {keys::k_output_x, &data_t::output_x},
+                            {keys::k_output_y, &data_t::output_y},
+                            {keys::k_width, &data_t::width},
+                            {keys::k_height, &data_t::height}}};
+
+  const auto read_integer{[this](auto &value) -> bool {
+    const int c{peek()};
+    if ((c != '-') && ((c < '0') || (c > '9'))) {
+      return skip_value();
+    }
+    std::string_view number{};
+    if (!read_number(number)) {
+      return false;
+    }
+    value = 0;
+    std::from_chars(number.data(), (number.data() + number.size()), value);
+    return true;
+  }};
+
+  // the name keeps its capacity, assigning an interned name does not
+  // allocate once it is large enough
+  click_event.id.name.clear();
+  click_event.id.instance = plugin_id::null;
+  click_event.data = {};
+
+  if (!expect(json_constants::k_object_opening_delimiter)) {
+    return false;
+  }
+  skip_whitespace();
+  if (peek() == json_constants::k_object_closing_delimiter) {
+    get();
+    return true;
+  }
+
+  while (true) {
+    skip_whitespace();
+    if (!read_string()) {
+      return false;
+    }
+    const std::string_view key{string()};
+    skip_whitespace();
+    if (!expect(json_constants::k_name_value_separator)) {
+      return false;
+    }
+    skip_whitespace();
+
+    bool value_ok{false};
+    if (key == keys::k_name) {
+      if (peek() == json_constants::k_string_delimiter) {
+        value_ok = read_string();
+        // a truncated name cannot be one that was sent
+        if (value_ok && (m_string_size <= m_string.size())) {
+          const auto name{m_names.find(string())};
+          if (name != m_names.end()) {
+            click_event.id.name = *name;
+          }
+        }
+      } else {
+        value_ok = skip_value();
+      }
+    } else if (key == keys::k_instance) {
+      if (peek() == json_constants::k_string_delimiter) {
+        value_ok = read_string();
+        if (value_ok) {
+          click_event.id.instance = plugin_id::from_string(string());
+        }
+      } else {
+        value_ok = skip_value();
+      }
+    } else if (key == keys::k_button) {
+      value_ok = read_integer(click_event.data.button);
+    } else if (key == keys::k_modifiers) {
+      value_ok = ((peek() == json_constants::k_array_opening_delimiter)
+                      ? (read_modifiers(click_event.data.modifiers))
+                      : (skip_value()));
+    } else {
+      const auto field{std::find_if(
+          k_pixel_count_fields.begin(), k_pixel_count_fields.end(),
+          [key](const std::pair<std::string_view, pixel_count_t data_t::*>
+                    &cur) -> bool { return cur.first == key; })};
+      value_ok = ((field != k_pixel_count_fields.end())
+                      ? (read_integer(click_event.data.*(field->second)))
+                      : (skip_value()));
+    }
+    if (!value_ok) {
+      return false;
+    }
+
+    skip_whitespace();
+    if (peek() == json_constants::k_element_separator) {
+      get();
+    } else if (peek() == json_constants::k_object_closing_delimiter) {
+      get();
+      return true;
+    } else {
+      return false;
+    }
+  }
+}
+
+bool i3neostatus::click_event_reader::read_string() {
+  const auto hex_digit{[](const int c) -> int {
+    if ((c >= '0') && (c <= '9')) {
+      return (c - '0');
+    } else if ((c >= 'a') && (c <= 'f')) {
+      return (c - 'a' + 10);
+    } else if ((c >= 'A') && (c <= 'F')) {
+      return (c - 'A' + 10);
+    } else {
+      return -1;
+    }
+  }};
+  const auto append{[this](const char c) -> void {
+    if (m_string_size < m_string.size()) {
+      m_string[m_string_size] = c;
+    }
+    ++m_string_size;
+  }};
+  // \uXXXX, without the backslash, -1 if malformed
+  const auto read_code_unit{[this, &hex_digit]() -> long {
+    if (get() != 'u') {
+      return -1;
+    }
+    long code_unit{0};
+    for (std::size_t i{0}; i < 4; ++i) {
+      const int digit{hex_digit(get())};
+      if (digit < 0) {
+        return -1;
+      }
+      code_unit = ((code_unit << 4) | digit);
+    }
+    return code_unit;
+  }};
+
+  if (!expect(json_constants::k_string_delimiter)) {
+    return false;
+  }
+  m_string_size = 0;
+  while (true) {
+    const int c{get()};
+    if ((c == m_k_eof) || (c < 0x20)) {
+      // raw control characters (i.e. newlines) are not allowed in strings
+      return false;
+    } else if (c == json_constants::k_string_delimiter) {
+      break;
+    } else if (c != json_constants::k_escape_leader) {
+      append(static_cast<char>(c));
+      continue;
+    }
+
+    const int escaped{peek()};
+    switch (escaped) {
+    case '"':
+    case '\\':
+    case '/': {
+      append(static_cast<char>(get()));
+    } break;
+    case 'b': {
+      get();
+      append('\b');
+    } break;
+    case 'f': {
+      get();
+      append('\f');
+    } break;
+    case 'n': {
+      get();
+      append('\n');
+    } break;
+    case 'r': {
+      get();
+      append('\r');
+    } break;
+    case 't': {
+      get();
+      append('\t');
+    } break;
+    case 'u': {
+      long code_point{read_code_unit()};
+      if (code_point < 0) {
+        return false;
+      }
+      if ((code_point >= 0xD800) && (code_point <= 0xDBFF)) {
+        const long low{((get() == json_constants::k_escape_leader)
+                             ? (read_code_unit())
+                             : (-1))};
+        if ((low < 0xDC00) || (low > 0xDFFF)) {
+          return false;
+        }
+        code_point = (0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00));
+      } else if ((code_point >= 0xDC00) && (code_point <= 0xDFFF)) {
+        return false;
+      }
+      if (code_point < 0x80) {
+        append(static_cast<char>(code_point));
+      } else if (code_point < 0x800) {
+        append(static_cast<char>(0xC0 | (code_point >> 6)));
+        append(static_cast<char>(0x80 | (code_point & 0x3F)));
+      } else if (code_point < 0x10000) {
+        append(static_cast<char>(0xE0 | (code_point >> 12)));
+        append(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        append(static_cast<char>(0x80 | (code_point & 0x3F)));
+      } else {
+        append(static_cast<char>(0xF0 | (code_point >> 18)));
+        append(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        append(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        append(static_cast<char>(0x80 | (code_point & 0x3F)));
+      }
+    } break;
+    default: {
+      return false;
+    } break;
+    }
+  }
+  return true;
+}
+
+bool i3neostatus::click_event_reader::read_number(std::string_view &number) {
+  std::size_t size{0};
+  while (true) {
+    const int c{peek()};
+    if (((c >= '0') && (c <= '9')) || (c == '-') || (c == '+') ||
+        (c == '.') || (c == 'e') || (c == 'E')) {
+      if (size < m_number.size()) {
+        m_number[size] = static_cast<char>(c);
+      }
+      ++size;
+      get();
+    } else {
+      break;
+    }
+  }
+  // fractions and exponents are accepted, but only the integer part is used
+  number = {m_number.data(), std::min(size, m_number.size())};
+  return (size != 0);
+}
+
+bool i3neostatus::click_event_reader::read_modifiers(
+    i3bar_data::types::click_modifiers &modifiers) {
+  if (!expect(json_constants::k_array_opening_delimiter)) {
+    return false;
+  }
+  skip_whitespace();
+  if (peek() == json_constants::k_array_closing_delimiter) {
+    get();
+    return true;
+  }
+  while (true) {
+    skip_whitespace();
+    if (peek() == json_constants::k_string_delimiter) {
+      if (!read_string()) {
+        return false;
+      }
+      modifiers |= i3bar_data::types::click_modifier_from_string(string());
+    } else if (!skip_value(1)) {
+      return false;
+    }
+    skip_whitespace();
+    if (peek() == json_constants::k_element_separator) {
+      get();
+    } else if (peek() == json_constants::k_array_closing_delimiter) {
+      get();
+      return true;
+    } else {
+      return false;
+    }
+  }
+}
+
+bool i3neostatus::click_event_reader::skip_value(
+    const std::size_t depth /*= 0*/) {
+  // i3bar never nests this deep, a limit keeps garbage off the stack
+  static constexpr std::size_t k_max_depth{32};
+
+  const int c{peek()};
+  if (c == json_constants::k_string_delimiter) {
+    return read_string();
+  } else if ((c == '-') || ((c >= '0') && (c <= '9'))) {
+    std::string_view number{};
+    return read_number(number);
+  } else if ((c >= 'a') && (c <= 'z')) {
+    // true, false, null
+    while ((peek() >= 'a') && (peek() <= 'z')) {
+      get();
+    }
+    return true;
+  } else if (((c != json_constants::k_object_opening_delimiter) &&
+              (c != json_constants::k_array_opening_delimiter)) ||
+             (depth >= k_max_depth)) {
+    return false;
+  }
+
+  const bool object{c == json_constants::k_object_opening_delimiter};
+  const int closing{((object) ? (json_constants::k_object_closing_delimiter)
+                              : (json_constants::k_array_closing_delimiter))};
+  get();
+  skip_whitespace();
+  if (peek() == closing) {
+    get();
+    return true;
+  }
+  while (true) {
+    skip_whitespace();
+    if (object) {
+      if (!read_string()) {
+        return false;
+      }
+      skip_whitespace();
+      if (!expect(json_constants::k_name_value_separator)) {
+        return false;
+      }
+      skip_whitespace();
+    }
+    if (!skip_value(depth + 1)) {
+      return false;
+    }
+    skip_whitespace();
+    if (peek() == json_constants::k_element_separator) {
+      get();
+    } else if (peek() == closing) {
+      get();
+      return true;
+    } else {
+      return false;
+    }
+  }
+}
+
+std::string_view i3neostatus::click_event_reader::string() const {
+  return {m_string.data(), std::min(m_string_size, m_string.size())};
+}
@@ -0,0 +1,82 @@
+#ifndef I3NEOSTATUS_CLICK_EVENT_READER_HPP
+#define I3NEOSTATUS_CLICK_EVENT_READER_HPP
+
+#include "i3bar_data.hpp"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace i3neostatus {
+
+// streams the click events i3bar writes to standard input, an endless JSON
+// array of objects, straight from the fd through a fixed buffer. the array
+// framing and the separating commas are handled by the tokenizer itself, not
+// by splitting lines, and malformed objects are skipped. apart from the block
+// name (looked up in a table of the names that were sent, and assigned into
+// the reused event) nothing is allocated per event
+class click_event_reader {
+private:
+  static constexpr std::size_t m_k_buffer_size{4096};
+  // longer strings are truncated, no key or known name is this long
+  static constexpr std::size_t m_k_string_size{256};
+  static constexpr std::size_t m_k_number_size{32};
+  static constexpr int m_k_eof{-1};
+
+  struct name_hash {
+    using is_transparent = void;
+    std::size_t operator()(const std::string_view name) const {
+      return std::hash<std::string_view>{}(name);
+    }
+  };
+
+private:
+  int m_fd;
+  std::array<char, m_k_buffer_size> m_buffer;
+  std::size_t m_pos;
+  std::size_t m_end;
+  bool m_in_array;
+  // last string read by read_string(), unescaped
+  std::array<char, m_k_string_size> m_string;
+  std::size_t m_string_size;
+  // last number read by read_number()
+  std::array<char, m_k_number_size> m_number;
+  std::unordered_set<std::string, name_hash, std::equal_to<>> m_names;
+
+public:
+  click_event_reader(const int fd, const std::vector<std::string> &names);
+  click_event_reader(click_event_reader &&other) noexcept = delete;
+  click_event_reader(const click_event_reader &other) = delete;
+
+public:
+  ~click_event_reader();
+
+public:
+  click_event_reader &operator=(click_event_reader &&other) noexcept = delete;
+  click_event_reader &operator=(const click_event_reader &other) = delete;
+
+public:
+  // blocks until the next complete event has been read into click_event,
+  // false once the input ends
+  bool read(i3bar_data::click_event &click_event);
+
+private:
+  int peek();
+  int get();
+  void skip_whitespace();
+  // these return false on a syntax error
+  bool expect(const char c);
+  bool read_object(i3bar_data::click_event &click_event);
+  bool read_string();
+  bool read_number(std::string_view &number);
+  bool read_modifiers(i3bar_data::types::click_modifiers &modifiers);
+  bool skip_value(const std::size_t depth = 0);
+  std::string_view string() const;
+};
+
+} // namespace i3neostatus
+#endif
@@ -0,0 +1,148 @@
+#include "click_mailbox.hpp"
+
+#include "metrics.hpp"
+#include "plugin_api.hpp"
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+i3neostatus::click_mailbox::click_mailbox(const std::size_t depth,
+                                          const plugin_api::drop_policy drop,
+                                          timer_wheel *timer_wheel,
+                                          const clock::duration scroll_window,
+                                          metrics::counter *dropped)
+    : m_mtx{}, m_events(std::max<std::size_t>(depth, 1)), m_head{0},
+      m_size{0}, m_drop{drop}, m_timer_wheel{timer_wheel},
+      m_scroll_window{scroll_window}, m_tail_since{std::nullopt},
+      m_notify_timer{timer_wheel::k_no_timer}, m_notify{},
+      m_dropped{dropped} {}
+
+i3neostatus::click_mailbox::~click_mailbox() {
+  timer_wheel::timer_id timer;
+  {
+    std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+    timer = std::exchange(m_notify_timer, timer_wheel::k_no_timer);
+  }
+  // waits for a running on_scroll_window(), which takes m_mtx
+  if (timer != timer_wheel::k_no_timer) {
+    m_timer_wheel->cancel(timer);
+  }
+}
+
+void i3neostatus::click_mailbox::set_notify(notify_callback &&notify) {
+  m_notify = std::move(notify);
+}
+
+void i3neostatus::click_mailbox::put(plugin_api::click_event &&click_event) {
+  const bool coalesce{(m_scroll_window > clock::duration::zero()) &&
+                      is_scroll(click_event)};
+  const clock::time_point now{(coalesce) ? (clock::now())
+                                         : (clock::time_point{})};
+  bool notify{false};
+  {
+    std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+    if (coalesce && tail_held(now)) {
+      plugin_api::click_event &tail{
+          m_events[(m_head + m_size - 1) % m_events.size()]};
+      if ((tail.button == click_event.button) &&
+          (tail.modifiers == click_event.modifiers)) {
+        // the latest position, every step so far
+        click_event.scroll_delta += tail.scroll_delta;
+        tail = std::move(click_event);
+        return;
+      }
+    }
+
+    const bool was_empty{available() == 0};
+    if (m_size == m_events.size()) {
+      m_dropped->fetch_add(1, std::memory_order_relaxed);
+      if (m_drop == plugin_api::drop_policy::newest) {
+        return;
+      }
+      m_head = (m_head + 1) % m_events.size();
+      --m_size;
+    }
+    m_events[(m_head + m_size) % m_events.size()] = std::move(click_event);
+    ++m_size;
+
+    if (coalesce) {
+      m_tail_since = now;
+      // one that is already armed (for an earlier tail) re-arms itself
+      if (m_notify_timer == timer_wheel::k_no_timer) {
+        m_notify_timer = m_timer_wheel->schedule_at(
+            (now + m_scroll_window), [this]() { on_scroll_window(); });
+      }
+    } else {
+      // a held back scroll does not delay other events, it is released with
+      // them
+      m_tail_since = std::nullopt;
+    }
+    // also a held scroll that is no longer the tail
+    notify = (was_empty && (available() != 0));
+  }
+  if (notify && m_notify) {
+    m_notify();
+  }
+}
+
+std::optional<i3neostatus::plugin_api::click_event>
+i3neostatus::click_mailbox::take() {
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  if (available() == 0) {
+    return std::nullopt;
+  }
+  std::optional<plugin_api::click_event> ret_val{std::move(m_events[m_head])};
+  m_head = (m_head + 1) % m_events.size();
+  if (--m_size == 0) {
+    m_tail_since = std::nullopt;
+  }
+  return ret_val;
+}
+
+bool i3neostatus::click_mailbox::empty() {
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  return (available() == 0);
+}
+
+bool i3neostatus::click_mailbox::is_scroll(
+    const plugin_api::click_event &click_event) {
+  return ((click_event.button >= m_k_first_scroll_button) &&
+          (click_event.button <= m_k_last_scroll_button));
+}
+
+bool i3neostatus::click_mailbox::tail_held(
+    const clock::time_point now) const {
+  return (m_tail_since && ((now - *m_tail_since) < m_scroll_window));
+}
+
+std::size_t i3neostatus::click_mailbox::available() const {
+  return ((m_tail_since && tail_held(clock::now())) ? (m_size - 1)
+                                                     : (m_size));
+}
+
+void i3neostatus::click_mailbox::on_scroll_window() {
+  {
+    std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+    // the destructor took it and waits for this call
+    if (m_notify_timer == timer_wheel::k_no_timer) {
+      return;
+    }
+    // a later scroll started the tail after this timer was armed
+    if (tail_held(clock::now())) {
+      m_notify_timer = m_timer_wheel->schedule_at(
+          (*m_tail_since + m_scroll_window), [this]() { on_scroll_window(); });
+      return;
+    }
+    m_notify_timer = timer_wheel::k_no_timer;
+  }
+  if (m_notify) {
+    m_notify();
+  }
+}
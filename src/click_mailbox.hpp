@@ -0,0 +1,84 @@
+#ifndef I3NEOSTATUS_CLICK_MAILBOX_HPP
+#define I3NEOSTATUS_CLICK_MAILBOX_HPP
+
+#include "metrics.hpp"
+#include "plugin_api.hpp"
+#include "timer_wheel.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace i3neostatus {
+
+// bounded FIFO of the click events sent to one plugin, filled by the click
+// event listener thread and drained on the plugin's own execution context,
+// which notify tells about the empty -> non-empty transition. the ring is
+// allocated once, a put into a full mailbox discards either the oldest queued
+// event or the new one (counted in dropped).
+// with a scroll window, a scroll event (button 4 to 7) that would start a
+// new entry is held back until the window has passed: take() and empty()
+// skip it, even for a consumer that is already draining, and the same scroll
+// on the same block is merged into it by adding up scroll_delta. it is
+// announced once the window has passed, unless another event is put after it
+// first (which ends the merging and makes both available)
+class click_mailbox {
+public:
+  using clock = timer_wheel::clock;
+  using notify_callback = std::function<void()>;
+
+private:
+  static constexpr int m_k_first_scroll_button{4};
+  static constexpr int m_k_last_scroll_button{7};
+
+private:
+  std::mutex m_mtx;
+  std::vector<plugin_api::click_event> m_events;
+  std::size_t m_head;
+  std::size_t m_size;
+  plugin_api::drop_policy m_drop;
+  timer_wheel *m_timer_wheel;
+  clock::duration m_scroll_window;
+  // when the last queued event started, only for a mergeable scroll
+  std::optional<clock::time_point> m_tail_since;
+  // armed while the tail is held
+  timer_wheel::timer_id m_notify_timer;
+  notify_callback m_notify;
+  metrics::counter *m_dropped;
+
+public:
+  // depth is at least one, timer_wheel is only needed with a scroll_window
+  click_mailbox(const std::size_t depth, const plugin_api::drop_policy drop,
+                timer_wheel *timer_wheel, const clock::duration scroll_window,
+                metrics::counter *dropped);
+  click_mailbox(click_mailbox &&other) noexcept = delete;
+  click_mailbox(const click_mailbox &other) = delete;
+
+public:
+  ~click_mailbox();
+
+public:
+  click_mailbox &operator=(click_mailbox &&other) noexcept = delete;
+  click_mailbox &operator=(const click_mailbox &other) = delete;
+
+public:
+  // before the first put(), nothing is announced without it
+  void set_notify(notify_callback &&notify);
+
+  void put(plugin_api::click_event &&click_event);
+  std::optional<plugin_api::click_event> take();
+  bool empty();
+
+private:
+  static bool is_scroll(const plugin_api::click_event &click_event);
+  // with m_mtx held
+  bool tail_held(const clock::time_point now) const;
+  std::size_t available() const;
+  void on_scroll_window();
+};
+
+} // namespace i3neostatus
+#endif
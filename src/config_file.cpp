@@ -2,15 +2,19 @@
 
 #include "config.h"
 
+#include "plugin_api.hpp"
 #include "theme.hpp"
 
 #include "bits-and-bytes/constexpr_hash_string.hpp"
 #include "bits-and-bytes/resolve_tilde.hpp"
 
+#include <chrono>
+#include <cstddef>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
 #include <limits>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -250,6 +254,32 @@ i3neostatus::config_file::impl::section_handlers::general(
                   libconfigfile::node_type::Integer));
         }
       } break;
+      case (bits_and_bytes::constexpr_hash_string::hash(
+          constants::option_str::k_general_max_frame_rate)): {
+        ret_val.max_frame_rate = general_helpers::read_bounded_integer(
+            path, ptr2->second, ptr2->first,
+            constants::error_str::k_range_frame_rate);
+      } break;
+      case (bits_and_bytes::constexpr_hash_string::hash(
+          constants::option_str::k_general_frame_coalescing_window)): {
+        ret_val.frame_coalescing_window =
+            std::chrono::milliseconds{general_helpers::read_bounded_integer(
+                path, ptr2->second, ptr2->first,
+                constants::error_str::k_range_coalescing_window)};
+      } break;
+      case (bits_and_bytes::constexpr_hash_string::hash(
+          constants::option_str::k_general_poll_threads)): {
+        ret_val.poll_threads = general_helpers::read_bounded_integer(
+            path, ptr2->second, ptr2->first,
+            constants::error_str::k_range_poll_threads);
+      } break;
+      case (bits_and_bytes::constexpr_hash_string::hash(
+          constants::option_str::k_general_timer_slack)): {
+        ret_val.timer_slack =
+            std::chrono::milliseconds{general_helpers::read_bounded_integer(
+                path, ptr2->second, ptr2->first,
+                constants::error_str::k_range_timer_slack)};
+      } break;
       default: {
         throw error_helpers::invalid_option(
             path,
@@ -267,6 +297,34 @@ i3neostatus::config_file::impl::section_handlers::general(
   return ret_val;
 }
 
+unsigned int i3neostatus::config_file::impl::section_handlers::
+    general_helpers::read_bounded_integer(
+        const std::string &path,
+        libconfigfile::node_ptr<libconfigfile::node> &&ptr,
+        const std::string &option_str,
+        const std::pair<unsigned int, unsigned int> &valid_range) {
+  if (ptr->get_node_type() == libconfigfile::node_type::Integer) {
+    const libconfigfile::integer_node::base_t value{libconfigfile::node_to_base(
+        std::move(*libconfigfile::node_ptr_cast<libconfigfile::integer_node>(
+            std::move(ptr))))};
+    if ((value <= valid_range.second) && (value >= valid_range.first)) {
+      return static_cast<unsigned int>(value);
+    } else {
+      throw error_helpers::invalid_range_for(
+          path,
+          (constants::option_str::k_general +
+           error_helpers::k_nested_option_separator_char + option_str),
+          valid_range);
+    }
+  } else {
+    throw error_helpers::invalid_data_type_for(
+        path,
+        (constants::option_str::k_general +
+         error_helpers::k_nested_option_separator_char + option_str),
+        libconfigfile::node_type_to_str(libconfigfile::node_type::Integer));
+  }
+}
+
 decltype(i3neostatus::config_file::parsed::theme)
 i3neostatus::config_file::impl::section_handlers::theme(
     const std::string &path,
@@ -628,6 +686,32 @@ i3neostatus::config_file::impl::section_handlers::plugins(
                       libconfigfile::node_type::Map));
             }
           } break;
+          case (bits_and_bytes::constexpr_hash_string::hash(
+              constants::option_str::k_plugins_history_depth)): {
+            ret_val[std::distance(ptr1_array->begin(), ptr2)].history_depth =
+                plugins_helpers::read_queue_depth(
+                    path, ptr3->second, ptr3->first,
+                    constants::error_str::k_range_history_depth);
+          } break;
+          case (bits_and_bytes::constexpr_hash_string::hash(
+              constants::option_str::k_plugins_history_drop)): {
+            ret_val[std::distance(ptr1_array->begin(), ptr2)].history_drop =
+                plugins_helpers::read_drop_policy(path, ptr3->second,
+                                                  ptr3->first);
+          } break;
+          case (bits_and_bytes::constexpr_hash_string::hash(
+              constants::option_str::k_plugins_click_depth)): {
+            ret_val[std::distance(ptr1_array->begin(), ptr2)].click_depth =
+                plugins_helpers::read_queue_depth(
+                    path, ptr3->second, ptr3->first,
+                    constants::error_str::k_range_click_depth);
+          } break;
+          case (bits_and_bytes::constexpr_hash_string::hash(
+              constants::option_str::k_plugins_click_drop)): {
+            ret_val[std::distance(ptr1_array->begin(), ptr2)].click_drop =
+                plugins_helpers::read_drop_policy(path, ptr3->second,
+                                                  ptr3->first);
+          } break;
           default: {
             throw error_helpers::invalid_option(
                 path,
@@ -658,3 +742,60 @@ i3neostatus::config_file::impl::section_handlers::plugins(
 
   return ret_val;
 }
+
+std::size_t i3neostatus::config_file::impl::section_handlers::plugins_helpers::
+    read_queue_depth(const std::string &path,
+                     libconfigfile::node_ptr<libconfigfile::node> &&ptr,
+                     const std::string &option_str,
+                     const std::pair<std::size_t, std::size_t> &range) {
+  if (ptr->get_node_type() == libconfigfile::node_type::Integer) {
+    const libconfigfile::integer_node::base_t value{libconfigfile::node_to_base(
+        std::move(*libconfigfile::node_ptr_cast<libconfigfile::integer_node>(
+            std::move(ptr))))};
+    if ((value >= 0) && (static_cast<std::size_t>(value) >= range.first) &&
+        (static_cast<std::size_t>(value) <= range.second)) {
+      return static_cast<std::size_t>(value);
+    } else {
+      throw error_helpers::invalid_range_for(
+          path,
+          (constants::option_str::k_plugins +
+           error_helpers::k_nested_option_separator_char + option_str),
+          range);
+    }
+  } else {
+    throw error_helpers::invalid_data_type_for(
+        path,
+        (constants::option_str::k_plugins +
+         error_helpers::k_nested_option_separator_char + option_str),
+        libconfigfile::node_type_to_str(libconfigfile::node_type::Integer));
+  }
+}
+
+i3neostatus::plugin_api::drop_policy i3neostatus::config_file::impl::
+    section_handlers::plugins_helpers::read_drop_policy(
+        const std::string &path,
+        libconfigfile::node_ptr<libconfigfile::node> &&ptr,
+        const std::string &option_str) {
+  if (ptr->get_node_type() == libconfigfile::node_type::String) {
+    const std::string value{libconfigfile::node_to_base(
+        std::move(*libconfigfile::node_ptr_cast<libconfigfile::string_node>(
+            std::move(ptr))))};
+    if (value == constants::option_str::k_plugins_drop_oldest) {
+      return plugin_api::drop_policy::oldest;
+    } else if (value == constants::option_str::k_plugins_drop_newest) {
+      return plugin_api::drop_policy::newest;
+    } else {
+      throw error_helpers::invalid_format_for(
+          path,
+          (constants::option_str::k_plugins +
+           error_helpers::k_nested_option_separator_char + option_str),
+          constants::error_str::k_format_drop_policy);
+    }
+  } else {
+    throw error_helpers::invalid_data_type_for(
+        path,
+        (constants::option_str::k_plugins +
+         error_helpers::k_nested_option_separator_char + option_str),
+        libconfigfile::node_type_to_str(libconfigfile::node_type::String));
+  }
+}
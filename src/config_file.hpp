@@ -1,13 +1,17 @@
 #ifndef I3NEOSTATUS_CONFIG_FILE_HPP
 #define I3NEOSTATUS_CONFIG_FILE_HPP
 
+#include "plugin_api.hpp"
 #include "theme.hpp"
 
 #include "bits-and-bytes/constexpr_hash_string.hpp"
 #include "libconfigfile/libconfigfile.hpp"
 
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
 #include <limits>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -46,11 +50,19 @@ public:
 struct parsed {
   struct general {
     bool custom_separators;
+    unsigned int max_frame_rate{0};
+    std::chrono::milliseconds frame_coalescing_window{5};
+    unsigned int poll_threads{2};
+    std::chrono::milliseconds timer_slack{10};
   };
 
   struct plugin {
     std::variant<std::filesystem::path, std::string> path_or_name;
     libconfigfile::map_node config;
+    std::optional<std::size_t> history_depth;
+    std::optional<plugin_api::drop_policy> history_drop;
+    std::optional<std::size_t> click_depth;
+    std::optional<plugin_api::drop_policy> click_drop;
   };
 
   struct general general;
@@ -88,6 +100,11 @@ namespace option_str {
 static constexpr std::string k_general{"general"};
 static constexpr std::string_view k_general_custom_separators{
     "custom_separators"};
+static constexpr std::string_view k_general_max_frame_rate{"max_frame_rate"};
+static constexpr std::string_view k_general_frame_coalescing_window{
+    "frame_coalescing_window"};
+static constexpr std::string_view k_general_poll_threads{"poll_threads"};
+static constexpr std::string_view k_general_timer_slack{"timer_slack"};
 
 static constexpr std::string k_theme{"theme"};
 static constexpr std::string_view k_theme_idle_color_foreground{
@@ -161,6 +178,12 @@ static constexpr std::string_view k_theme_border_width_left{
 static constexpr std::string k_plugins{"plugins"};
 static constexpr std::string k_plugins_path_or_name{"path_or_name"};
 static constexpr std::string k_plugins_config{"config"};
+static constexpr std::string k_plugins_history_depth{"history_depth"};
+static constexpr std::string k_plugins_history_drop{"history_drop"};
+static constexpr std::string k_plugins_click_depth{"click_depth"};
+static constexpr std::string k_plugins_click_drop{"click_drop"};
+static constexpr std::string k_plugins_drop_oldest{"oldest"};
+static constexpr std::string k_plugins_drop_newest{"newest"};
 } // namespace option_str
 
 namespace error_str {
@@ -173,6 +196,19 @@ static const std::string k_format_color_or_special_str{k_format_color +
 static constexpr std::pair<theme::pixel_count_t, theme::pixel_count_t>
     k_range_pixel_count{std::numeric_limits<theme::pixel_count_t>::lowest(),
                         std::numeric_limits<theme::pixel_count_t>::max()};
+static constexpr std::pair<unsigned int, unsigned int> k_range_frame_rate{
+    0, 1000};
+static constexpr std::pair<unsigned int, unsigned int>
+    k_range_coalescing_window{0, 1000};
+static constexpr std::pair<unsigned int, unsigned int> k_range_poll_threads{
+    1, 64};
+static constexpr std::pair<unsigned int, unsigned int> k_range_timer_slack{
+    1, 1000};
+static constexpr std::pair<std::size_t, std::size_t> k_range_history_depth{
+    0, 1024};
+static constexpr std::pair<std::size_t, std::size_t> k_range_click_depth{
+    1, 1024};
+static const std::string k_format_drop_policy{"\"oldest\" or \"newest\""};
 } // namespace error_str
 } // namespace constants
 
@@ -206,7 +242,12 @@ namespace section_handlers {
 decltype(parsed::general)
 general(const std::string &path,
         libconfigfile::node_ptr<libconfigfile::node, true> &&ptr);
-namespace general_helpers {}
+namespace general_helpers {
+unsigned int read_bounded_integer(
+    const std::string &path, libconfigfile::node_ptr<libconfigfile::node> &&ptr,
+    const std::string &option_str,
+    const std::pair<unsigned int, unsigned int> &valid_range);
+}
 
 decltype(parsed::theme)
 theme(const std::string &_path,
@@ -325,7 +366,18 @@ read_border_width(const std::string &path,
 decltype(parsed::plugins)
 plugins(const std::string &path,
         libconfigfile::node_ptr<libconfigfile::node, true> &&ptr);
-namespace plugins_helpers {}
+namespace plugins_helpers {
+std::size_t
+read_queue_depth(const std::string &path,
+                 libconfigfile::node_ptr<libconfigfile::node> &&ptr,
+                 const std::string &option_str,
+                 const std::pair<std::size_t, std::size_t> &range);
+
+plugin_api::drop_policy
+read_drop_policy(const std::string &path,
+                 libconfigfile::node_ptr<libconfigfile::node> &&ptr,
+                 const std::string &option_str);
+} // namespace plugins_helpers
 } // namespace section_handlers
 } // namespace impl
 } // namespace config_file
@@ -0,0 +1,296 @@
+#include "coro_executor.hpp"
+
+#include "click_mailbox.hpp"
+#include "coro_plugin_base.hpp"
+#include "event_loop.hpp"
+#include "metrics.hpp"
+#include "plugin_api.hpp"
+#include "thread_stats.hpp"
+
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+i3neostatus::coro_executor::coro_executor(const std::size_t capacity)
+    : m_event_loop{}, m_timer{},
+      m_event_fd{eventfd(0, (EFD_NONBLOCK | EFD_CLOEXEC))},
+      m_contexts(capacity), m_timers{}, m_messages_mtx{}, m_messages{},
+      m_messages_swap{}, m_next_id{0}, m_exit{false}, m_thread{} {
+  if (m_event_fd == -1) {
+    throw std::system_error{errno, std::generic_category(), "eventfd()"};
+  }
+  m_event_loop.add(m_event_fd, EPOLLIN,
+                   static_cast<std::uint32_t>(event_source::messages));
+  m_event_loop.add(m_timer.get_fd(), EPOLLIN,
+                   static_cast<std::uint32_t>(event_source::timer));
+  m_thread = std::thread{[this]() {
+    thread_stats::set_name("i3ns-coro");
+    loop();
+  }};
+}
+
+i3neostatus::coro_executor::~coro_executor() {
+  post({.type{message_type::exit}});
+  m_thread.join();
+  // only left over if a plugin was never terminated
+  for (context &cur_context : m_contexts) {
+    if (cur_context.task) {
+      cur_context.task.destroy();
+    }
+  }
+  close(m_event_fd);
+}
+
+i3neostatus::coro_executor::context_id i3neostatus::coro_executor::reserve() {
+  const context_id id{m_next_id.fetch_add(1, std::memory_order_relaxed)};
+  if (id >= m_contexts.size()) {
+    throw std::length_error{"coro_executor::reserve()"};
+  }
+  return id;
+}
+
+void i3neostatus::coro_executor::spawn(const context_id id, coro_task &&task,
+                                       coro_plugin_base *plugin,
+                                       const std::size_t plugin_id,
+                                       click_mailbox *clicks,
+                                       const done_callback done,
+                                       void *userdata) {
+  post({.type{message_type::spawn},
+        .id{id},
+        .task{task.release()},
+        .plugin{plugin},
+        .plugin_id{plugin_id},
+        .done{done},
+        .userdata{userdata},
+        .clicks{clicks}});
+}
+
+void i3neostatus::coro_executor::notify_click_event(const context_id id) {
+  post({.type{message_type::click}, .id{id}});
+}
+
+void i3neostatus::coro_executor::cancel(const context_id id) {
+  post({.type{message_type::cancel}, .id{id}});
+}
+
+void i3neostatus::coro_executor::stop(const context_id id) {
+  post({.type{message_type::stop}, .id{id}});
+}
+
+void i3neostatus::coro_executor::cont(const context_id id) {
+  post({.type{message_type::cont}, .id{id}});
+}
+
+bool i3neostatus::coro_executor::is_cancelled(const context_id id) const {
+  return m_contexts[id].cancelled;
+}
+
+bool i3neostatus::coro_executor::has_click_event(const context_id id) const {
+  return !m_contexts[id].clicks->empty();
+}
+
+std::optional<i3neostatus::plugin_api::click_event>
+i3neostatus::coro_executor::get_click_event(const context_id id) {
+  std::optional<plugin_api::click_event> ret_val{
+      m_contexts[id].clicks->take()};
+  if (ret_val) {
+    metrics::click_dispatched(m_contexts[id].plugin_id);
+  }
+  return ret_val;
+}
+
+void i3neostatus::coro_executor::wait_time(
+    const context_id id, const std::coroutine_handle<> waiter,
+    const coro_api::clock::time_point expiry) {
+  context &cur_context{m_contexts[id]};
+  cur_context.waiter = waiter;
+  cur_context.waiting = wait_type::time;
+  m_timers.push({expiry, id, ++cur_context.generation});
+  if (m_timers.top().expiry == expiry) {
+    m_timer.arm(expiry);
+  }
+}
+
+void i3neostatus::coro_executor::wait_readable(
+    const context_id id, const std::coroutine_handle<> waiter, const int fd) {
+  context &cur_context{m_contexts[id]};
+  cur_context.waiter = waiter;
+  cur_context.waiting = wait_type::readable;
+  cur_context.fd = fd;
+  m_event_loop.add(fd, (EPOLLIN | EPOLLONESHOT),
+                   (static_cast<std::uint32_t>(event_source::first_context) +
+                    static_cast<std::uint32_t>(id)));
+}
+
+void i3neostatus::coro_executor::wait_click_event(
+    const context_id id, const std::coroutine_handle<> waiter) {
+  context &cur_context{m_contexts[id]};
+  cur_context.waiter = waiter;
+  cur_context.waiting = wait_type::click;
+}
+
+void i3neostatus::coro_executor::post(message &&message) {
+  {
+    std::lock_guard<std::mutex> lock_m_messages_mtx{m_messages_mtx};
+    m_messages.push_back(std::move(message));
+  }
+  eventfd_write(m_event_fd, 1);
+}
+
+void i3neostatus::coro_executor::loop() {
+  while (!m_exit) {
+    for (const epoll_event &event : m_event_loop.wait()) {
+      switch (static_cast<event_source>(event.data.u32)) {
+      case event_source::messages: {
+        handle_messages();
+      } break;
+      case event_source::timer: {
+        m_timer.clear();
+        handle_timers();
+      } break;
+      default: {
+        const context_id id{
+            event.data.u32 -
+            static_cast<std::uint32_t>(event_source::first_context)};
+        context &cur_context{m_contexts[id]};
+        if (cur_context.waiting == wait_type::readable) {
+          m_event_loop.remove(cur_context.fd);
+          wake(cur_context);
+        }
+      } break;
+      }
+    }
+  }
+}
+
+void i3neostatus::coro_executor::handle_messages() {
+  eventfd_t value{};
+  eventfd_read(m_event_fd, &value);
+  {
+    std::lock_guard<std::mutex> lock_m_messages_mtx{m_messages_mtx};
+    m_messages.swap(m_messages_swap);
+  }
+  for (message &cur_message : m_messages_swap) {
+    if (cur_message.type == message_type::exit) {
+      m_exit = true;
+      continue;
+    }
+    context &cur_context{m_contexts[cur_message.id]};
+    switch (cur_message.type) {
+    case message_type::spawn: {
+      cur_context = context{.task{cur_message.task},
+                            .plugin{cur_message.plugin},
+                            .plugin_id{cur_message.plugin_id},
+                            .done{cur_message.done},
+                            .userdata{cur_message.userdata},
+                            .waiter{cur_message.task},
+                            .waiting{wait_type::none},
+                            .generation{0},
+                            .fd{-1},
+                            .cancelled{false},
+                            .paused{false},
+                            .timer_due{false},
+                            .clicks{cur_message.clicks}};
+      resume(cur_context);
+    } break;
+    case message_type::click: {
+      // the event may already have been taken by an earlier click(), after
+      // another wakeup
+      if ((cur_context.task) && (cur_context.waiting == wait_type::click) &&
+          (!cur_context.clicks->empty())) {
+        wake(cur_context);
+      }
+    } break;
+    case message_type::cancel: {
+      cur_context.cancelled = true;
+      if (cur_context.waiting == wait_type::readable) {
+        m_event_loop.remove(cur_context.fd);
+      }
+      if (cur_context.waiting != wait_type::none) {
+        wake(cur_context);
+      }
+    } break;
+    case message_type::stop: {
+      cur_context.paused = true;
+    } break;
+    case message_type::cont: {
+      cur_context.paused = false;
+      if (cur_context.timer_due) {
+        cur_context.timer_due = false;
+        wake(cur_context);
+      }
+    } break;
+    case message_type::exit:
+    default: {
+    } break;
+    }
+  }
+  m_messages_swap.clear();
+}
+
+void i3neostatus::coro_executor::handle_timers() {
+  const coro_api::clock::time_point now{coro_api::clock::now()};
+  while ((!m_timers.empty()) && (m_timers.top().expiry <= now)) {
+    const timer cur_timer{m_timers.top()};
+    m_timers.pop();
+    context &cur_context{m_contexts[cur_timer.id]};
+    // stale if the context was woken by something else in the meantime
+    if ((cur_context.waiting == wait_type::time) &&
+        (cur_context.generation == cur_timer.generation)) {
+      if (cur_context.paused) {
+        cur_context.timer_due = true;
+      } else {
+        wake(cur_context);
+      }
+    }
+  }
+  arm_timer();
+}
+
+void i3neostatus::coro_executor::arm_timer() {
+  if (!m_timers.empty()) {
+    m_timer.arm(m_timers.top().expiry);
+  }
+}
+
+void i3neostatus::coro_executor::wake(context &context) {
+  context.waiting = wait_type::none;
+  context.timer_due = false;
+  ++context.generation;
+  resume(context);
+}
+
+void i3neostatus::coro_executor::resume(context &context) {
+  std::coroutine_handle<> waiter{std::exchange(context.waiter, nullptr)};
+  const thread_stats::usage usage_begin{thread_stats::read_self()};
+  waiter.resume();
+  metrics::add_wakeup(context.plugin_id, usage_begin,
+                      thread_stats::read_self());
+  std::exception_ptr exception{nullptr};
+  if (context.task.done()) {
+    exception = context.task.promise().exception;
+  } else if (context.waiting == wait_type::none) {
+    // nothing would ever resume it
+    exception = std::make_exception_ptr(
+        std::logic_error{"coroutine suspended outside of coro_api"});
+  } else {
+    return;
+  }
+  context.task.destroy();
+  context.task = nullptr;
+  context.done(context.userdata, exception);
+  context.plugin->set_done();
+}
@@ -0,0 +1,153 @@
+#ifndef I3NEOSTATUS_CORO_EXECUTOR_HPP
+#define I3NEOSTATUS_CORO_EXECUTOR_HPP
+
+#include "click_mailbox.hpp"
+#include "coro_plugin_base.hpp"
+#include "event_loop.hpp"
+#include "plugin_api.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace i3neostatus {
+
+// runs the coroutines of every coro_plugin_base on a single thread. a
+// coroutine waits on at most one thing at a time (a deadline, a readable fd
+// or a click event), timers share one timerfd and fds are registered
+// one-shot with the executor's epoll instance. the other threads only talk
+// to it through a locked message queue and an eventfd, click events are
+// taken straight from the plugin's mailbox (the message only wakes it)
+class coro_executor {
+public:
+  using context_id = std::size_t;
+  using done_callback = void (*)(void *userdata, std::exception_ptr exception);
+
+private:
+  enum class wait_type {
+    none,
+    time,
+    readable,
+    click,
+  };
+
+  struct context {
+    coro_task::handle_type task;
+    coro_plugin_base *plugin;
+    std::size_t plugin_id; // for metrics
+    done_callback done;
+    void *userdata;
+    std::coroutine_handle<> waiter;
+    wait_type waiting;
+    std::uint64_t generation;
+    int fd;
+    bool cancelled;
+    bool paused;
+    bool timer_due;
+    click_mailbox *clicks;
+  };
+
+  struct timer {
+    coro_api::clock::time_point expiry;
+    context_id id;
+    std::uint64_t generation;
+
+    bool operator>(const timer &other) const { return expiry > other.expiry; }
+  };
+
+  enum class message_type {
+    spawn,
+    click,
+    cancel,
+    stop,
+    cont,
+    exit,
+  };
+
+  struct message {
+    message_type type;
+    context_id id;
+    coro_task::handle_type task;
+    coro_plugin_base *plugin;
+    std::size_t plugin_id;
+    done_callback done;
+    void *userdata;
+    click_mailbox *clicks;
+  };
+
+  enum class event_source : std::uint32_t {
+    messages,
+    timer,
+    first_context,
+  };
+
+private:
+  event_loop m_event_loop;
+  timer_fd m_timer;
+  int m_event_fd;
+  std::vector<context> m_contexts;
+  std::priority_queue<timer, std::vector<timer>, std::greater<timer>>
+      m_timers;
+  std::mutex m_messages_mtx;
+  std::vector<message> m_messages;
+  std::vector<message> m_messages_swap;
+  std::atomic<context_id> m_next_id;
+  bool m_exit;
+  std::thread m_thread;
+
+public:
+  explicit coro_executor(const std::size_t capacity);
+  coro_executor(coro_executor &&other) noexcept = delete;
+  coro_executor(const coro_executor &other) = delete;
+
+public:
+  ~coro_executor();
+
+public:
+  coro_executor &operator=(coro_executor &&other) noexcept = delete;
+  coro_executor &operator=(const coro_executor &other) = delete;
+
+public:
+  // any thread
+  context_id reserve();
+  void spawn(const context_id id, coro_task &&task, coro_plugin_base *plugin,
+             const std::size_t plugin_id, click_mailbox *clicks,
+             const done_callback done, void *userdata);
+  // the context's mailbox has to be drained
+  void notify_click_event(const context_id id);
+  void cancel(const context_id id);
+  void stop(const context_id id);
+  void cont(const context_id id);
+
+public:
+  // executor thread (from inside the coroutine)
+  bool is_cancelled(const context_id id) const;
+  bool has_click_event(const context_id id) const;
+  std::optional<plugin_api::click_event> get_click_event(const context_id id);
+  void wait_time(const context_id id, const std::coroutine_handle<> waiter,
+                 const coro_api::clock::time_point expiry);
+  void wait_readable(const context_id id, const std::coroutine_handle<> waiter,
+                     const int fd);
+  void wait_click_event(const context_id id,
+                        const std::coroutine_handle<> waiter);
+
+private:
+  void post(message &&message);
+  void loop();
+  void handle_messages();
+  void handle_timers();
+  void arm_timer();
+  void wake(context &context);
+  void resume(context &context);
+};
+
+} // namespace i3neostatus
+#endif
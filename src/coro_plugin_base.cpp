@@ -0,0 +1,208 @@
+#include "coro_plugin_base.hpp"
+
+#include "click_mailbox.hpp"
+#include "coro_executor.hpp"
+#include "plugin_api.hpp"
+#include "plugin_base.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+i3neostatus::coro_task
+i3neostatus::coro_task::promise_type::get_return_object() {
+  return coro_task{handle_type::from_promise(*this)};
+}
+
+i3neostatus::coro_task::coro_task(const handle_type handle)
+    : m_handle{handle} {}
+
+i3neostatus::coro_task::coro_task(coro_task &&other) noexcept
+    : m_handle{std::exchange(other.m_handle, nullptr)} {}
+
+i3neostatus::coro_task::~coro_task() {
+  if (m_handle) {
+    m_handle.destroy();
+  }
+}
+
+i3neostatus::coro_task &
+i3neostatus::coro_task::operator=(coro_task &&other) noexcept {
+  if (this != &other) {
+    if (m_handle) {
+      m_handle.destroy();
+    }
+    m_handle = std::exchange(other.m_handle, nullptr);
+  }
+  return *this;
+}
+
+i3neostatus::coro_task::handle_type i3neostatus::coro_task::release() {
+  return std::exchange(m_handle, nullptr);
+}
+
+i3neostatus::coro_api::sleep_awaiter::sleep_awaiter(
+    coro_api *api, const clock::time_point expiry)
+    : m_api{api}, m_expiry{expiry} {}
+
+bool i3neostatus::coro_api::sleep_awaiter::await_ready() const {
+  return m_api->m_executor->is_cancelled(m_api->m_context);
+}
+
+void i3neostatus::coro_api::sleep_awaiter::await_suspend(
+    const std::coroutine_handle<> handle) {
+  m_api->m_executor->wait_time(m_api->m_context, handle, m_expiry);
+}
+
+bool i3neostatus::coro_api::sleep_awaiter::await_resume() const {
+  return !m_api->m_executor->is_cancelled(m_api->m_context);
+}
+
+i3neostatus::coro_api::readable_awaiter::readable_awaiter(coro_api *api,
+                                                          const int fd)
+    : m_api{api}, m_fd{fd} {}
+
+bool i3neostatus::coro_api::readable_awaiter::await_ready() const {
+  return m_api->m_executor->is_cancelled(m_api->m_context);
+}
+
+void i3neostatus::coro_api::readable_awaiter::await_suspend(
+    const std::coroutine_handle<> handle) {
+  m_api->m_executor->wait_readable(m_api->m_context, handle, m_fd);
+}
+
+bool i3neostatus::coro_api::readable_awaiter::await_resume() const {
+  return !m_api->m_executor->is_cancelled(m_api->m_context);
+}
+
+i3neostatus::coro_api::click_awaiter::click_awaiter(coro_api *api)
+    : m_api{api} {}
+
+bool i3neostatus::coro_api::click_awaiter::await_ready() const {
+  return (m_api->m_executor->is_cancelled(m_api->m_context) ||
+          m_api->m_executor->has_click_event(m_api->m_context));
+}
+
+void i3neostatus::coro_api::click_awaiter::await_suspend(
+    const std::coroutine_handle<> handle) {
+  m_api->m_executor->wait_click_event(m_api->m_context, handle);
+}
+
+std::optional<i3neostatus::plugin_api::click_event>
+i3neostatus::coro_api::click_awaiter::await_resume() {
+  return ((m_api->m_executor->is_cancelled(m_api->m_context))
+              ? (std::nullopt)
+              : (m_api->m_executor->get_click_event(m_api->m_context)));
+}
+
+i3neostatus::coro_api::coro_api(plugin_api *plugin_api,
+                                coro_executor *executor,
+                                const std::size_t context)
+    : m_plugin_api{plugin_api}, m_executor{executor}, m_context{context} {}
+
+i3neostatus::coro_api::~coro_api() {}
+
+void i3neostatus::coro_api::put_block(const plugin_api::block &block) {
+  m_plugin_api->put_block(block);
+}
+
+void i3neostatus::coro_api::put_block(plugin_api::block &&block) {
+  m_plugin_api->put_block(std::move(block));
+}
+
+void i3neostatus::coro_api::put_error(const std::exception_ptr &error) {
+  m_plugin_api->put_error(error);
+}
+
+void i3neostatus::coro_api::put_error(std::exception_ptr &&error) {
+  m_plugin_api->put_error(std::move(error));
+}
+
+void i3neostatus::coro_api::hide() { m_plugin_api->hide(); }
+
+i3neostatus::coro_api::sleep_awaiter
+i3neostatus::coro_api::sleep_until(const clock::time_point expiry) {
+  return sleep_awaiter{this, expiry};
+}
+
+i3neostatus::coro_api::sleep_awaiter
+i3neostatus::coro_api::sleep_for(const clock::duration duration) {
+  return sleep_awaiter{this, (clock::now() + duration)};
+}
+
+i3neostatus::coro_api::readable_awaiter
+i3neostatus::coro_api::readable(const int fd) {
+  return readable_awaiter{this, fd};
+}
+
+i3neostatus::coro_api::click_awaiter i3neostatus::coro_api::click() {
+  return click_awaiter{this};
+}
+
+i3neostatus::coro_plugin_base::coro_plugin_base()
+    : m_coro_api{std::nullopt}, m_clicks{nullptr}, m_done{false} {}
+
+i3neostatus::coro_plugin_base::~coro_plugin_base() {}
+
+void i3neostatus::coro_plugin_base::start(
+    coro_executor &executor, plugin_api *api, const std::size_t id,
+    click_mailbox *clicks,
+    void (*done)(void *userdata, std::exception_ptr exception),
+    void *userdata) {
+  const coro_executor::context_id context{executor.reserve()};
+  m_coro_api.emplace(api, &executor, context);
+  m_clicks = clicks;
+  try {
+    m_clicks->set_notify([&executor, context]() {
+      executor.notify_click_event(context);
+    });
+    executor.spawn(context, run_coroutine(*m_coro_api), this, id, m_clicks,
+                   done, userdata);
+  } catch (...) {
+    // never spawned, so nothing will call set_done() and term() must not
+    // wait for it
+    m_clicks->set_notify(nullptr);
+    m_clicks = nullptr;
+    m_coro_api.reset();
+    throw;
+  }
+}
+
+void i3neostatus::coro_plugin_base::run() {
+  throw std::logic_error{"coroutine plugin run without an executor"};
+}
+
+void i3neostatus::coro_plugin_base::term() {
+  if (m_coro_api) {
+    m_coro_api->m_executor->cancel(m_coro_api->m_context);
+    m_done.wait(false);
+  }
+}
+
+void i3neostatus::coro_plugin_base::on_click_event(
+    plugin_api::click_event &&click_event) {
+  if (m_clicks != nullptr) {
+    m_clicks->put(std::move(click_event));
+  }
+}
+
+void i3neostatus::coro_plugin_base::on_stop() {
+  if (m_coro_api) {
+    m_coro_api->m_executor->stop(m_coro_api->m_context);
+  }
+}
+
+void i3neostatus::coro_plugin_base::on_cont() {
+  if (m_coro_api) {
+    m_coro_api->m_executor->cont(m_coro_api->m_context);
+  }
+}
+
+void i3neostatus::coro_plugin_base::set_done() {
+  m_done.store(true);
+  m_done.notify_all();
+}
@@ -0,0 +1,187 @@
+#ifndef I3NEOSTATUS_CORO_PLUGIN_BASE_HPP
+#define I3NEOSTATUS_CORO_PLUGIN_BASE_HPP
+
+#include "plugin_api.hpp"
+#include "plugin_base.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+
+namespace i3neostatus {
+
+class click_mailbox;
+class coro_executor;
+
+// return type of coro_plugin_base::run_coroutine(), the coroutine does not
+// start until it is handed to the executor
+class coro_task {
+public:
+  struct promise_type {
+    std::exception_ptr exception;
+
+    coro_task get_return_object();
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { exception = std::current_exception(); }
+  };
+
+  using handle_type = std::coroutine_handle<promise_type>;
+
+private:
+  handle_type m_handle;
+
+public:
+  explicit coro_task(const handle_type handle);
+  coro_task(coro_task &&other) noexcept;
+  coro_task(const coro_task &other) = delete;
+
+public:
+  ~coro_task();
+
+public:
+  coro_task &operator=(coro_task &&other) noexcept;
+  coro_task &operator=(const coro_task &other) = delete;
+
+public:
+  handle_type release();
+};
+
+// everything a coroutine plugin may await, the awaitables only work inside
+// the coroutine started by the executor. every wait completes early (with
+// false/nullopt) once the plugin is being terminated
+class coro_api {
+public:
+  using clock = std::chrono::steady_clock;
+
+  class sleep_awaiter {
+  private:
+    coro_api *m_api;
+    clock::time_point m_expiry;
+
+  public:
+    sleep_awaiter(coro_api *api, const clock::time_point expiry);
+
+  public:
+    bool await_ready() const;
+    void await_suspend(const std::coroutine_handle<> handle);
+    bool await_resume() const;
+  };
+
+  class readable_awaiter {
+  private:
+    coro_api *m_api;
+    int m_fd;
+
+  public:
+    readable_awaiter(coro_api *api, const int fd);
+
+  public:
+    bool await_ready() const;
+    void await_suspend(const std::coroutine_handle<> handle);
+    bool await_resume() const;
+  };
+
+  class click_awaiter {
+  private:
+    coro_api *m_api;
+
+  public:
+    explicit click_awaiter(coro_api *api);
+
+  public:
+    bool await_ready() const;
+    void await_suspend(const std::coroutine_handle<> handle);
+    std::optional<plugin_api::click_event> await_resume();
+  };
+
+private:
+  plugin_api *m_plugin_api;
+  coro_executor *m_executor;
+  std::size_t m_context;
+
+public:
+  coro_api(plugin_api *plugin_api, coro_executor *executor,
+           const std::size_t context);
+  coro_api(coro_api &&other) noexcept = delete;
+  coro_api(const coro_api &other) = delete;
+
+public:
+  ~coro_api();
+
+public:
+  coro_api &operator=(coro_api &&other) noexcept = delete;
+  coro_api &operator=(const coro_api &other) = delete;
+
+public:
+  void put_block(const plugin_api::block &block);
+  void put_block(plugin_api::block &&block);
+  void put_error(const std::exception_ptr &error);
+  void put_error(std::exception_ptr &&error);
+  void hide();
+
+  // true once the deadline passed, deferred while the bar is stopped
+  sleep_awaiter sleep_until(const clock::time_point expiry);
+  sleep_awaiter sleep_for(const clock::duration duration);
+
+  // true once fd is readable
+  readable_awaiter readable(const int fd);
+
+  // the next click event sent to the plugin
+  click_awaiter click();
+
+  friend class coro_plugin_base;
+};
+
+// plugins deriving from this class implement run_coroutine() instead of
+// run() and all of them share one executor thread instead of each getting a
+// thread of its own. term(), on_click_event(), on_stop() and on_cont() are
+// handled by this class, the coroutine should return once an await reports
+// that it is being terminated
+class coro_plugin_base : public plugin_base {
+private:
+  std::optional<coro_api> m_coro_api;
+  click_mailbox *m_clicks;
+  std::atomic<bool> m_done;
+
+public:
+  coro_plugin_base();
+
+public:
+  virtual ~coro_plugin_base() override;
+
+public:
+  virtual coro_task run_coroutine(coro_api &api) = 0;
+
+  // called by plugin_handle instead of run(), done is called (on the
+  // executor thread) with the exception the coroutine exited with, if any.
+  // on_click_event() puts into clicks, click() takes from it
+  void start(coro_executor &executor, plugin_api *api, const std::size_t id,
+             click_mailbox *clicks,
+             void (*done)(void *userdata, std::exception_ptr exception),
+             void *userdata);
+
+public:
+  virtual void run() override final;
+
+  virtual void term() override final;
+
+  virtual void
+  on_click_event(plugin_api::click_event &&click_event) override final;
+
+  virtual void on_stop() override final;
+
+  virtual void on_cont() override final;
+
+private:
+  void set_done();
+
+  friend class coro_executor;
+};
+
+} // namespace i3neostatus
+#endif
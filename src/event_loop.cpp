@@ -0,0 +1,219 @@
+#include "event_loop.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <system_error>
+
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+i3neostatus::event_loop::event_loop()
+    : m_epoll_fd{epoll_create1(EPOLL_CLOEXEC)}, m_events{} {
+  if (m_epoll_fd == -1) {
+    throw std::system_error{errno, std::generic_category(), "epoll_create1()"};
+  }
+}
+
+i3neostatus::event_loop::event_loop(event_loop &&other) noexcept
+    : m_epoll_fd{other.m_epoll_fd}, m_events{} {
+  other.m_epoll_fd = -1;
+}
+
+i3neostatus::event_loop::~event_loop() {
+  if (m_epoll_fd != -1) {
+    close(m_epoll_fd);
+  }
+}
+
+i3neostatus::event_loop &
+i3neostatus::event_loop::operator=(event_loop &&other) noexcept {
+  if (this != &other) {
+    if (m_epoll_fd != -1) {
+      close(m_epoll_fd);
+    }
+    m_epoll_fd = other.m_epoll_fd;
+    other.m_epoll_fd = -1;
+  }
+  return *this;
+}
+
+void i3neostatus::event_loop::add(const int fd, const std::uint32_t events,
+                                  const std::uint32_t tag) {
+  epoll_event event{.events{events}, .data{.u32{tag}}};
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+    throw std::system_error{errno, std::generic_category(), "epoll_ctl()"};
+  }
+}
+
+void i3neostatus::event_loop::modify(const int fd, const std::uint32_t events,
+                                     const std::uint32_t tag) {
+  epoll_event event{.events{events}, .data{.u32{tag}}};
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &event) == -1) {
+    throw std::system_error{errno, std::generic_category(), "epoll_ctl()"};
+  }
+}
+
+void i3neostatus::event_loop::remove(const int fd) {
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr) == -1) {
+    throw std::system_error{errno, std::generic_category(), "epoll_ctl()"};
+  }
+}
+
+std::span<const epoll_event>
+i3neostatus::event_loop::wait(const int timeout_ms /*= -1*/) {
+  while (true) {
+    const int count{epoll_wait(m_epoll_fd, m_events.data(),
+                               static_cast<int>(m_events.size()), timeout_ms)};
+    if (count != -1) {
+      return {m_events.data(), static_cast<std::size_t>(count)};
+    } else if (errno != EINTR) {
+      throw std::system_error{errno, std::generic_category(), "epoll_wait()"};
+    }
+  }
+}
+
+i3neostatus::timer_fd::timer_fd()
+    : m_fd{timerfd_create(CLOCK_MONOTONIC, (TFD_NONBLOCK | TFD_CLOEXEC))},
+      m_armed{false} {
+  static_assert(clock::is_steady);
+  if (m_fd == -1) {
+    throw std::system_error{errno, std::generic_category(), "timerfd_create()"};
+  }
+}
+
+i3neostatus::timer_fd::timer_fd(timer_fd &&other) noexcept
+    : m_fd{other.m_fd}, m_armed{other.m_armed} {
+  other.m_fd = -1;
+  other.m_armed = false;
+}
+
+i3neostatus::timer_fd::~timer_fd() {
+  if (m_fd != -1) {
+    close(m_fd);
+  }
+}
+
+i3neostatus::timer_fd &
+i3neostatus::timer_fd::operator=(timer_fd &&other) noexcept {
+  if (this != &other) {
+    if (m_fd != -1) {
+      close(m_fd);
+    }
+    m_fd = other.m_fd;
+    m_armed = other.m_armed;
+    other.m_fd = -1;
+    other.m_armed = false;
+  }
+  return *this;
+}
+
+void i3neostatus::timer_fd::arm(const clock::time_point expiry) {
+  const std::chrono::nanoseconds since_epoch{
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          expiry.time_since_epoch())};
+  itimerspec value{};
+  value.it_value.tv_sec = static_cast<time_t>(since_epoch.count() /
+                                              1'000'000'000);
+  value.it_value.tv_nsec = static_cast<long>(since_epoch.count() %
+                                             1'000'000'000);
+  if ((value.it_value.tv_sec == 0) && (value.it_value.tv_nsec == 0)) {
+    value.it_value.tv_nsec = 1; // all-zero would disarm the timer instead
+  }
+  if (timerfd_settime(m_fd, TFD_TIMER_ABSTIME, &value, nullptr) == -1) {
+    throw std::system_error{errno, std::generic_category(),
+                            "timerfd_settime()"};
+  }
+  m_armed = true;
+}
+
+void i3neostatus::timer_fd::disarm() {
+  const itimerspec value{};
+  if (timerfd_settime(m_fd, 0, &value, nullptr) == -1) {
+    throw std::system_error{errno, std::generic_category(),
+                            "timerfd_settime()"};
+  }
+  m_armed = false;
+}
+
+std::uint64_t i3neostatus::timer_fd::clear() {
+  std::uint64_t expirations{0};
+  if ((::read(m_fd, &expirations, sizeof(expirations)) == -1) &&
+      (errno != EAGAIN)) {
+    throw std::system_error{errno, std::generic_category(), "read()"};
+  }
+  m_armed = false;
+  return expirations;
+}
+
+bool i3neostatus::timer_fd::is_armed() const { return m_armed; }
+
+int i3neostatus::timer_fd::get_fd() const { return m_fd; }
+
+i3neostatus::signal_fd::signal_fd(const std::initializer_list<int> signals)
+    : m_fd{-1}, m_signals{} {
+  sigemptyset(&m_signals);
+  for (const int signal : signals) {
+    sigaddset(&m_signals, signal);
+  }
+  m_fd = signalfd(-1, &m_signals, (SFD_NONBLOCK | SFD_CLOEXEC));
+  if (m_fd == -1) {
+    throw std::system_error{errno, std::generic_category(), "signalfd()"};
+  }
+}
+
+i3neostatus::signal_fd::signal_fd(signal_fd &&other) noexcept
+    : m_fd{other.m_fd}, m_signals{other.m_signals} {
+  other.m_fd = -1;
+}
+
+i3neostatus::signal_fd::~signal_fd() {
+  if (m_fd != -1) {
+    close(m_fd);
+  }
+}
+
+i3neostatus::signal_fd &
+i3neostatus::signal_fd::operator=(signal_fd &&other) noexcept {
+  if (this != &other) {
+    if (m_fd != -1) {
+      close(m_fd);
+    }
+    m_fd = other.m_fd;
+    m_signals = other.m_signals;
+    other.m_fd = -1;
+  }
+  return *this;
+}
+
+int i3neostatus::signal_fd::read() {
+  signalfd_siginfo info{};
+  if (::read(m_fd, &info, sizeof(info)) == -1) {
+    if (errno == EAGAIN) {
+      return 0;
+    } else {
+      throw std::system_error{errno, std::generic_category(), "read()"};
+    }
+  }
+  return static_cast<int>(info.ssi_signo);
+}
+
+int i3neostatus::signal_fd::get_fd() const { return m_fd; }
+
+void i3neostatus::signal_fd::block(const std::initializer_list<int> signals) {
+  sigset_t set{};
+  sigemptyset(&set);
+  for (const int signal : signals) {
+    sigaddset(&set, signal);
+  }
+  const int error{pthread_sigmask(SIG_BLOCK, &set, nullptr)};
+  if (error != 0) {
+    throw std::system_error{error, std::generic_category(),
+                            "pthread_sigmask()"};
+  }
+}
@@ -0,0 +1,103 @@
+#ifndef I3NEOSTATUS_EVENT_LOOP_HPP
+#define I3NEOSTATUS_EVENT_LOOP_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+
+#include <signal.h>
+#include <sys/epoll.h>
+
+namespace i3neostatus {
+
+class event_loop {
+private:
+  static constexpr std::size_t m_k_max_events{16};
+
+private:
+  int m_epoll_fd;
+  std::array<epoll_event, m_k_max_events> m_events;
+
+public:
+  event_loop();
+  event_loop(event_loop &&other) noexcept;
+  event_loop(const event_loop &other) = delete;
+
+public:
+  ~event_loop();
+
+public:
+  event_loop &operator=(event_loop &&other) noexcept;
+  event_loop &operator=(const event_loop &other) = delete;
+
+public:
+  void add(const int fd, const std::uint32_t events, const std::uint32_t tag);
+  void modify(const int fd, const std::uint32_t events,
+              const std::uint32_t tag);
+  void remove(const int fd);
+
+  std::span<const epoll_event> wait(const int timeout_ms = -1);
+};
+
+class timer_fd {
+public:
+  using clock = std::chrono::steady_clock;
+
+private:
+  int m_fd;
+  bool m_armed;
+
+public:
+  timer_fd();
+  timer_fd(timer_fd &&other) noexcept;
+  timer_fd(const timer_fd &other) = delete;
+
+public:
+  ~timer_fd();
+
+public:
+  timer_fd &operator=(timer_fd &&other) noexcept;
+  timer_fd &operator=(const timer_fd &other) = delete;
+
+public:
+  void arm(const clock::time_point expiry);
+  void disarm();
+  std::uint64_t clear();
+
+  bool is_armed() const;
+  int get_fd() const;
+};
+
+class signal_fd {
+private:
+  int m_fd;
+  sigset_t m_signals;
+
+public:
+  explicit signal_fd(const std::initializer_list<int> signals);
+  signal_fd(signal_fd &&other) noexcept;
+  signal_fd(const signal_fd &other) = delete;
+
+public:
+  ~signal_fd();
+
+public:
+  signal_fd &operator=(signal_fd &&other) noexcept;
+  signal_fd &operator=(const signal_fd &other) = delete;
+
+public:
+  // returns 0 if no signal is pending
+  int read();
+
+  int get_fd() const;
+
+public:
+  // must be called before any other thread is started, so that every thread
+  // inherits the mask and the signals are only delivered through the fd
+  static void block(const std::initializer_list<int> signals);
+};
+
+} // namespace i3neostatus
+#endif
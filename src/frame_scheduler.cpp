@@ -0,0 +1,41 @@
+#include "frame_scheduler.hpp"
+
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+
+i3neostatus::frame_scheduler::frame_scheduler(
+    const unsigned int max_frame_rate, const clock::duration coalescing_window)
+    : m_min_frame_interval{((max_frame_rate != 0)
+                                ? (std::chrono::duration_cast<clock::duration>(
+                                      std::chrono::seconds{1}) /
+                                   max_frame_rate)
+                                : (clock::duration::zero()))},
+      m_coalescing_window{coalescing_window}, m_last_frame{},
+      m_pending_changes{0} {}
+
+i3neostatus::frame_scheduler::clock::time_point
+i3neostatus::frame_scheduler::next_frame(
+    const clock::time_point first_change) const {
+  return std::max((first_change + m_coalescing_window),
+                  (m_last_frame + m_min_frame_interval));
+}
+
+void i3neostatus::frame_scheduler::add_change() { ++m_pending_changes; }
+
+bool i3neostatus::frame_scheduler::frame_pending() const {
+  return (m_pending_changes != 0);
+}
+
+void i3neostatus::frame_scheduler::frame_written(const clock::time_point now) {
+  assert(m_pending_changes != 0);
+  // every change used to be written as its own frame
+  metrics::global.frames_written.fetch_add(1, std::memory_order_relaxed);
+  metrics::global.frames_dropped.fetch_add((m_pending_changes - 1),
+                                           std::memory_order_relaxed);
+  m_pending_changes = 0;
+  m_last_frame = now;
+}
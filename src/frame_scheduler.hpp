@@ -0,0 +1,32 @@
+#ifndef I3NEOSTATUS_FRAME_SCHEDULER_HPP
+#define I3NEOSTATUS_FRAME_SCHEDULER_HPP
+
+#include <chrono>
+#include <cstddef>
+
+namespace i3neostatus {
+
+class frame_scheduler {
+public:
+  using clock = std::chrono::steady_clock;
+
+private:
+  clock::duration m_min_frame_interval;
+  clock::duration m_coalescing_window;
+  clock::time_point m_last_frame;
+  std::size_t m_pending_changes;
+
+public:
+  frame_scheduler(const unsigned int max_frame_rate,
+                  const clock::duration coalescing_window);
+
+public:
+  clock::time_point next_frame(const clock::time_point first_change) const;
+
+  void add_change();
+  bool frame_pending() const;
+  void frame_written(const clock::time_point now);
+};
+
+} // namespace i3neostatus
+#endif
@@ -76,6 +76,9 @@ struct block {
 
       struct global global;
       struct theme theme;
+      // global and theme as they appear in the serialized block, if they
+      // were serialized ahead of time (see make_block::theme_table)
+      const std::string *serialized{nullptr};
     };
 
     struct plugin {
@@ -85,6 +88,8 @@ struct block {
       std::optional<types::text_align> align;
       std::optional<bool> urgent;
       std::optional<types::markup> markup;
+
+      bool operator==(const plugin &other) const = default;
     };
 
     struct program program;
@@ -112,6 +117,9 @@ struct click_event {
     types::pixel_count_t width;
     types::pixel_count_t height;
     types::click_modifiers modifiers;
+    // consecutive scroll events (buttons 4 to 7) merged into this one, see
+    // plugin_api::config_out::scroll_coalescing
+    int scroll_delta{1};
   };
 
   struct id id;
@@ -2,11 +2,11 @@
 
 #include "i3bar_data.hpp"
 
-#include "bits-and-bytes/constexpr_hash_string.hpp"
-
 #include <array>
 #include <cstddef>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 template <>
@@ -32,44 +32,28 @@ i3neostatus::i3bar_data::types::click_modifiers
 i3neostatus::i3bar_data::types::from_string<
     i3neostatus::i3bar_data::types::click_modifiers>(
     const std::string &string) {
-  static constexpr std::string k_str_mod1{"Mod1"};
-  static constexpr std::string k_str_mod2{"Mod2"};
-  static constexpr std::string k_str_mod3{"Mod3"};
-  static constexpr std::string k_str_mod4{"Mod4"};
-  static constexpr std::string k_str_mod5{"Mod5"};
-  static constexpr std::string k_str_shift{"Shift"};
-  static constexpr std::string k_str_control{"Control"};
-  static constexpr std::string k_str_lock{"Lock"};
+  return click_modifier_from_string(string);
+}
+
+i3neostatus::i3bar_data::types::click_modifiers
+i3neostatus::i3bar_data::types::click_modifier_from_string(
+    const std::string_view string) {
+  static constexpr std::array<std::pair<std::string_view, click_modifiers>, 8>
+      k_lut{{{"Mod1", click_modifiers::mod1},
+             {"Mod2", click_modifiers::mod2},
+             {"Mod3", click_modifiers::mod3},
+             {"Mod4", click_modifiers::mod4},
+             {"Mod5", click_modifiers::mod5},
+             {"Shift", click_modifiers::shift},
+             {"Control", click_modifiers::control},
+             {"Lock", click_modifiers::lock}}};
 
-  switch (bits_and_bytes::constexpr_hash_string::hash(string)) {
-  case bits_and_bytes::constexpr_hash_string::hash(k_str_mod1): {
-    return click_modifiers::mod1;
-  } break;
-  case bits_and_bytes::constexpr_hash_string::hash(k_str_mod2): {
-    return click_modifiers::mod2;
-  } break;
-  case bits_and_bytes::constexpr_hash_string::hash(k_str_mod3): {
-    return click_modifiers::mod3;
-  } break;
-  case bits_and_bytes::constexpr_hash_string::hash(k_str_mod4): {
-    return click_modifiers::mod4;
-  } break;
-  case bits_and_bytes::constexpr_hash_string::hash(k_str_mod5): {
-    return click_modifiers::mod5;
-  } break;
-  case bits_and_bytes::constexpr_hash_string::hash(k_str_shift): {
-    return click_modifiers::shift;
-  } break;
-  case bits_and_bytes::constexpr_hash_string::hash(k_str_control): {
-    return click_modifiers::control;
-  } break;
-  case bits_and_bytes::constexpr_hash_string::hash(k_str_lock): {
-    return click_modifiers::lock;
-  } break;
-  default: {
-    return click_modifiers::none;
-  } break;
+  for (const std::pair<std::string_view, click_modifiers> &cur : k_lut) {
+    if (cur.first == string) {
+      return cur.second;
+    }
   }
+  return click_modifiers::none;
 }
 
 template <>
@@ -4,6 +4,7 @@
 #include "i3bar_data.hpp"
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace i3neostatus {
@@ -21,6 +22,8 @@ click_modifiers from_string<click_modifiers>(const std::string &string);
 template <>
 click_modifiers
 from_string<click_modifiers>(const std::vector<std::string> &string);
+// a single modifier, without the std::string of from_string()
+click_modifiers click_modifier_from_string(const std::string_view string);
 } // namespace types
 } // namespace i3bar_data
 } // namespace i3neostatus
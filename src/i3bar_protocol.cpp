@@ -3,24 +3,28 @@
 #include "hide_block.hpp"
 #include "i3bar_data.hpp"
 #include "i3bar_data_conversions.hpp"
+#include "json_escape.hpp"
 #include "plugin_id.hpp"
+#include "statusline_writer.hpp"
+#include "utf8.hpp"
 
-#include "bits-and-bytes/constexpr_hash_string.hpp"
-#include "bits-and-bytes/constexpr_min_max.hpp"
 #include "bits-and-bytes/stream_append.hpp"
-#include "bits-and-bytes/unreachable_error.hpp"
 #include "libconfigfile/color.hpp"
 
+#include <array>
 #include <cassert>
 #include <charconv>
+#include <cstddef>
 #include <iostream>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <sys/uio.h>
+
 using namespace bits_and_bytes::stream_append;
 
 void i3neostatus::i3bar_protocol::print_header(
@@ -55,17 +59,15 @@ void i3neostatus::i3bar_protocol::print_statusline(
                          hide_empty, stream);
 }
 
-void i3neostatus::i3bar_protocol::print_statusline(
+void i3neostatus::i3bar_protocol::update_statusline(
     const struct i3bar_data::block &content,
     const plugin_id::type content_index,
-    std::vector<std::string> &content_cache, const bool hide_empty,
-    std::ostream &stream /*= std::cout*/) {
+    std::vector<std::string> &content_cache, const bool hide_empty) {
   content_cache[content_index].clear();
   impl::serialize_block(content_cache[content_index], content, hide_empty);
-  impl::print_statusline(content_cache, hide_empty, stream);
 }
 
-void i3neostatus::i3bar_protocol::print_statusline(
+void i3neostatus::i3bar_protocol::update_statusline(
     const struct i3bar_data::block &content,
     const plugin_id::type content_index,
     std::vector<std::string> &content_cache,
@@ -73,8 +75,7 @@ void i3neostatus::i3bar_protocol::print_statusline(
     const plugin_id::type separator_left_index,
     const i3bar_data::block &separator_right,
     const plugin_id::type separator_right_index,
-    std::vector<std::string> &separator_cache, const bool hide_empty,
-    std::ostream &stream) {
+    std::vector<std::string> &separator_cache, const bool hide_empty) {
   content_cache[content_index].clear();
   impl::serialize_block(content_cache[content_index], content, hide_empty);
   separator_cache[separator_left_index].clear();
@@ -83,41 +84,44 @@ void i3neostatus::i3bar_protocol::print_statusline(
   separator_cache[separator_right_index].clear();
   impl::serialize_block(separator_cache[separator_right_index], separator_right,
                         hide_empty);
-  impl::print_statusline(content_cache, separator_cache, hide_empty, stream);
 }
 
-void i3neostatus::i3bar_protocol::print_statusline(
+void i3neostatus::i3bar_protocol::update_statusline(
     const std::vector<struct i3bar_data::block> &content,
-    std::vector<std::string> &content_cache, const bool hide_empty,
-    std::ostream &stream /*= std::cout*/) {
+    std::vector<std::string> &content_cache, const bool hide_empty) {
   content_cache = impl::serialize_blocks(content, hide_empty);
-  impl::print_statusline(content_cache, hide_empty, stream);
 }
 
-void i3neostatus::i3bar_protocol::print_statusline(
+void i3neostatus::i3bar_protocol::update_statusline(
     const std::vector<struct i3bar_data::block> &content,
     std::vector<std::string> &content_cache,
     const std::vector<i3bar_data::block> &separators,
-    std::vector<std::string> &separator_cache, const bool hide_empty,
-    std::ostream &stream /*= std::cout*/) {
+    std::vector<std::string> &separator_cache, const bool hide_empty) {
   content_cache = impl::serialize_blocks(content, hide_empty);
   separator_cache = impl::serialize_blocks(separators, hide_empty);
-  impl::print_statusline(content_cache, separator_cache, hide_empty, stream);
 }
 
-void i3neostatus::i3bar_protocol::init_click_event(
-    std::istream &input_stream /*= std::cin*/) {
-  input_stream.ignore(1, json_constants::k_array_opening_delimiter);
-  input_stream.ignore(1, json_constants::k_newline);
+std::string i3neostatus::i3bar_protocol::serialize_program(
+    const struct i3bar_data::block::data::program &program) {
+  struct i3bar_data::block block{.data{.program{program}}};
+  block.data.program.serialized = nullptr;
+  std::string ret_val{};
+  impl::serialize_block_fields<true>(ret_val, block);
+  return ret_val;
 }
 
-i3neostatus::i3bar_data::click_event
-i3neostatus::i3bar_protocol::read_click_event(
-    std::istream &input_stream /*= std::cin*/) {
-  std::string input_str{};
-  std::getline(input_stream, input_str, json_constants::k_newline);
+bool i3neostatus::i3bar_protocol::print_statusline(
+    const std::vector<std::string> &content_cache, const bool hide_empty,
+    statusline_writer &writer) {
+  return impl::print_statusline(content_cache, hide_empty, writer);
+}
 
-  return impl::parse_click_event(input_str);
+bool i3neostatus::i3bar_protocol::print_statusline(
+    const std::vector<std::string> &content_cache,
+    const std::vector<std::string> &separator_cache, const bool hide_empty,
+    statusline_writer &writer) {
+  return impl::print_statusline(content_cache, separator_cache, hide_empty,
+                                writer);
 }
 
 void i3neostatus::i3bar_protocol::impl::print_statusline(
@@ -138,6 +142,86 @@ void i3neostatus::i3bar_protocol::impl::print_statusline(
   stream << json_constants::k_newline << std::flush;
 }
 
+bool i3neostatus::i3bar_protocol::impl::print_statusline(
+    const std::vector<std::string> &content, const bool hide_empty,
+    statusline_writer &writer) {
+  thread_local iovec_output output{};
+  output.clear();
+  output += json_constants::k_element_separator;
+  serialize_array(output, content, hide_empty);
+  output += json_constants::k_newline;
+  return writer.write(output.get());
+}
+
+bool i3neostatus::i3bar_protocol::impl::print_statusline(
+    const std::vector<std::string> &content,
+    const std::vector<std::string> &separators, const bool hide_empty,
+    statusline_writer &writer) {
+  assert((content.size() + 1) == separators.size());
+  thread_local iovec_output output{};
+  output.clear();
+  output += json_constants::k_element_separator;
+  serialize_array_interleave(output, separators, content, hide_empty);
+  output += json_constants::k_newline;
+  return writer.write(output.get());
+}
+
+i3neostatus::i3bar_protocol::impl::iovec_output::iovec_output() : m_iovecs{} {}
+
+i3neostatus::i3bar_protocol::impl::iovec_output::iovec_output(
+    iovec_output &&other) noexcept
+    : m_iovecs{std::move(other.m_iovecs)} {}
+
+i3neostatus::i3bar_protocol::impl::iovec_output::iovec_output(
+    const iovec_output &other)
+    : m_iovecs{other.m_iovecs} {}
+
+i3neostatus::i3bar_protocol::impl::iovec_output::~iovec_output() {}
+
+i3neostatus::i3bar_protocol::impl::iovec_output &
+i3neostatus::i3bar_protocol::impl::iovec_output::operator=(
+    iovec_output &&other) noexcept {
+  if (this != &other) {
+    m_iovecs = std::move(other.m_iovecs);
+  }
+  return *this;
+}
+
+i3neostatus::i3bar_protocol::impl::iovec_output &
+i3neostatus::i3bar_protocol::impl::iovec_output::operator=(
+    const iovec_output &other) {
+  if (this != &other) {
+    m_iovecs = other.m_iovecs;
+  }
+  return *this;
+}
+
+i3neostatus::i3bar_protocol::impl::iovec_output &
+i3neostatus::i3bar_protocol::impl::iovec_output::operator+=(
+    const std::string &string) {
+  if (!string.empty()) {
+    m_iovecs.push_back(iovec{.iov_base{const_cast<char *>(string.data())},
+                             .iov_len{string.size()}});
+  }
+  return *this;
+}
+
+i3neostatus::i3bar_protocol::impl::iovec_output &
+i3neostatus::i3bar_protocol::impl::iovec_output::operator+=(const char c) {
+  m_iovecs.push_back(iovec{
+      .iov_base{const_cast<char *>(&m_k_chars[static_cast<unsigned char>(c)])},
+      .iov_len{1}});
+  return *this;
+}
+
+void i3neostatus::i3bar_protocol::impl::iovec_output::clear() {
+  m_iovecs.clear();
+}
+
+std::span<iovec> i3neostatus::i3bar_protocol::impl::iovec_output::get() {
+  return m_iovecs;
+}
+
 template <typename t_output>
 t_output &i3neostatus::i3bar_protocol::impl::serialize_header(
     t_output &output, const i3bar_data::header &header) {
@@ -164,112 +248,175 @@ t_output &i3neostatus::i3bar_protocol::impl::serialize_header(
       }());
 }
 
-template <typename t_output>
-t_output &i3neostatus::i3bar_protocol::impl::serialize_block(
-    t_output &output, const struct i3bar_data::block &block,
-    const bool hide_empty) {
-  if (hide_block::get(block) && hide_empty) {
-    output += hide_block::set<std::string>();
-  } else {
-    serialize_object(
-        output, [&block]() -> std::vector<std::pair<std::string, std::string>> {
-          std::vector<std::pair<std::string, std::string>> ret_val;
-
-          ret_val.emplace_back(json_strings::block::k_name, std::string{});
-          serialize_string(ret_val.back().second, block.id.name);
-
-          ret_val.emplace_back(json_strings::block::k_instance, std::string{});
-          serialize_string(ret_val.back().second,
-                           std::to_string(block.id.instance));
-
-          ret_val.emplace_back(json_strings::block::k_separator, std::string{});
-          serialize_bool(ret_val.back().second,
-                         block.data.program.global.separator);
-
-          ret_val.emplace_back(json_strings::block::k_separator_block_width,
-                               std::string{});
-          serialize_number(ret_val.back().second,
-                           block.data.program.global.separator_block_width);
-
-          ret_val.emplace_back(json_strings::block::k_color, std::string{});
-          serialize_string(
-              ret_val.back().second,
-              libconfigfile::color::to_string(block.data.program.theme.color));
-
-          ret_val.emplace_back(json_strings::block::k_background,
-                               std::string{});
-          serialize_string(ret_val.back().second,
-                           libconfigfile::color::to_string(
-                               block.data.program.theme.background));
-
-          ret_val.emplace_back(json_strings::block::k_border, std::string{});
-          serialize_string(
-              ret_val.back().second,
-              libconfigfile::color::to_string(block.data.program.theme.border));
-
-          ret_val.emplace_back(json_strings::block::k_border_top,
-                               std::string{});
-          serialize_number(ret_val.back().second,
-                           block.data.program.theme.border_top);
-
-          ret_val.emplace_back(json_strings::block::k_border_right,
-                               std::string{});
-          serialize_number(ret_val.back().second,
-                           block.data.program.theme.border_right);
-
-          ret_val.emplace_back(json_strings::block::k_border_bottom,
-                               std::string{});
-          serialize_number(ret_val.back().second,
-                           block.data.program.theme.border_bottom);
-
-          ret_val.emplace_back(json_strings::block::k_border_left,
-                               std::string{});
-          serialize_number(ret_val.back().second,
-                           block.data.program.theme.border_left);
-
-          ret_val.emplace_back(json_strings::block::k_full_text, std::string{});
-          serialize_string(ret_val.back().second, block.data.plugin.full_text);
-
-          if (block.data.plugin.short_text.has_value()) {
-            ret_val.emplace_back(json_strings::block::k_short_text,
-                                 std::string{});
-            serialize_string(ret_val.back().second,
-                             *block.data.plugin.short_text);
-          }
-
-          if (block.data.plugin.min_width.has_value()) {
-            ret_val.emplace_back(json_strings::block::k_min_width,
-                                 std::string{});
-            ((block.data.plugin.min_width->index() == 0)
-                 ? (serialize_number(ret_val.back().second,
-                                     std::get<0>(*block.data.plugin.min_width)))
-                 : (serialize_string(
-                       ret_val.back().second,
-                       std::get<1>(*block.data.plugin.min_width))));
-          }
+template <bool t_program_only>
+std::string &i3neostatus::i3bar_protocol::impl::serialize_block_fields(
+    std::string &output, const struct i3bar_data::block &block) {
+  using block_t = struct i3bar_data::block;
+
+  // same order as the members of i3bar_data::block
+  static constexpr std::array<block_field, 17> k_fields{{
+      {"{\"name\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_string(output, block.id.name);
+       }},
+      {",\"instance\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         // digits only, nothing to escape
+         output += json_constants::k_string_delimiter;
+         serialize_number(output, block.id.instance);
+         output += json_constants::k_string_delimiter;
+       }},
+      {",\"separator\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_bool(output, block.data.program.global.separator);
+       }},
+      {",\"separator_block_width\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_number(output,
+                          block.data.program.global.separator_block_width);
+       }},
+      {",\"color\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_string(output, libconfigfile::color::to_string(
+                                      block.data.program.theme.color));
+       }},
+      {",\"background\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_string(output, libconfigfile::color::to_string(
+                                      block.data.program.theme.background));
+       }},
+      {",\"border\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_string(output, libconfigfile::color::to_string(
+                                      block.data.program.theme.border));
+       }},
+      {",\"border_top\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_number(output, block.data.program.theme.border_top);
+       }},
+      {",\"border_right\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_number(output, block.data.program.theme.border_right);
+       }},
+      {",\"border_bottom\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_number(output, block.data.program.theme.border_bottom);
+       }},
+      {",\"border_left\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_number(output, block.data.program.theme.border_left);
+       }},
+      {",\"full_text\":", nullptr,
+       [](std::string &output, const block_t &block) {
+         serialize_text(output, block.data.plugin.full_text);
+       }},
+      {",\"short_text\":",
+       [](const block_t &block) {
+         return block.data.plugin.short_text.has_value();
+       },
+       [](std::string &output, const block_t &block) {
+         serialize_text(output, *block.data.plugin.short_text);
+       }},
+      {",\"min_width\":",
+       [](const block_t &block) {
+         return block.data.plugin.min_width.has_value();
+       },
+       [](std::string &output, const block_t &block) {
+         ((block.data.plugin.min_width->index() == 0)
+              ? (serialize_number(output,
+                                  std::get<0>(*block.data.plugin.min_width)))
+              : (serialize_text(output,
+                                std::get<1>(*block.data.plugin.min_width))));
+       }},
+      {",\"align\":",
+       [](const block_t &block) {
+         return block.data.plugin.align.has_value();
+       },
+       [](std::string &output, const block_t &block) {
+         serialize_string(output, i3bar_data::types::to_string(
+                                      *block.data.plugin.align));
+       }},
+      {",\"urgent\":",
+       [](const block_t &block) {
+         return block.data.plugin.urgent.has_value();
+       },
+       [](std::string &output, const block_t &block) {
+         serialize_bool(output, *block.data.plugin.urgent);
+       }},
+      {",\"markup\":",
+       [](const block_t &block) {
+         return block.data.plugin.markup.has_value();
+       },
+       [](std::string &output, const block_t &block) {
+         serialize_string(output, i3bar_data::types::to_string(
+                                      *block.data.plugin.markup));
+       }},
+  }};
 
-          if (block.data.plugin.align.has_value()) {
-            ret_val.emplace_back(json_strings::block::k_align, std::string{});
-            serialize_string(
-                ret_val.back().second,
-                i3bar_data::types::to_string(*block.data.plugin.align));
-          }
+  // keys plus room for the values that do not depend on the plugin
+  static constexpr std::size_t k_fixed_size{[]() {
+    std::size_t size{128};
+    for (const block_field &cur_field : k_fields) {
+      size += cur_field.key.size();
+    }
+    return size;
+  }()};
+
+  // separator to border_left, i.e. i3bar_data::block::data::program
+  static constexpr std::size_t k_program_begin{2};
+  static constexpr std::size_t k_program_end{11};
+
+  if constexpr (!t_program_only) {
+    output.reserve(output.size() + k_fixed_size + block.id.name.size() +
+                   block.data.plugin.full_text.size() +
+                   ((block.data.plugin.short_text.has_value())
+                        ? (block.data.plugin.short_text->size())
+                        : (0)));
+  }
 
-          if (block.data.plugin.urgent.has_value()) {
-            ret_val.emplace_back(json_strings::block::k_urgent, std::string{});
-            serialize_bool(ret_val.back().second, *block.data.plugin.urgent);
-          }
+  // expanded at compile time, absent optional members cost one check each
+  const auto serialize_field{[&output, &block]<std::size_t t_index>() {
+    constexpr block_field k_field{k_fields[t_index]};
+    constexpr bool k_program_field{(t_index >= k_program_begin) &&
+                                   (t_index < k_program_end)};
+    if constexpr (t_program_only) {
+      if constexpr (!k_program_field) {
+        return;
+      }
+    } else if constexpr (k_program_field) {
+      if (block.data.program.serialized != nullptr) {
+        if constexpr (t_index == k_program_begin) {
+          output += *block.data.program.serialized;
+        }
+        return;
+      }
+    }
+    if constexpr (k_field.present != nullptr) {
+      if (!k_field.present(block)) {
+        return;
+      }
+    }
+    output += k_field.key;
+    k_field.value(output, block);
+  }};
+  [&serialize_field]<std::size_t... t_indices>(
+      std::index_sequence<t_indices...>) {
+    (serialize_field.template operator()<t_indices>(), ...);
+  }(std::make_index_sequence<k_fields.size()>{});
 
-          if (block.data.plugin.markup.has_value()) {
-            ret_val.emplace_back(json_strings::block::k_markup, std::string{});
-            serialize_string(
-                ret_val.back().second,
-                i3bar_data::types::to_string(*block.data.plugin.markup));
-          }
+  return output;
+}
 
-          return ret_val;
-        }());
+std::string &i3neostatus::i3bar_protocol::impl::serialize_block(
+    std::string &output, const struct i3bar_data::block &block,
+    const bool hide_empty) {
+  if (hide_block::get(block) && hide_empty) {
+    output += hide_block::set<std::string>();
+    return output;
   }
+
+  serialize_block_fields<false>(output, block);
+  output += json_constants::k_object_closing_delimiter;
   return output;
 }
 
@@ -346,8 +493,8 @@ t_output &i3neostatus::i3bar_protocol::impl::serialize_array_interleave(
   std::size_t idx2{0};
 
   const auto do_serialize{
-      [hide_empty, &remaining, &first](const std::vector<std::string> &a,
-                                       std::size_t &i) {
+      [&output, hide_empty, &remaining,
+       &first](const std::vector<std::string> &a, std::size_t &i) {
         for (;; ++i) {
           if (i == a.size()) {
             --remaining;
@@ -360,9 +507,9 @@ t_output &i3neostatus::i3bar_protocol::impl::serialize_array_interleave(
             if (first) {
               first = false;
             } else {
-              std::cout << json_constants::k_element_separator;
+              output += json_constants::k_element_separator;
             }
-            std::cout << a[i];
+            output += a[i];
             break;
           }
         }
@@ -382,53 +529,17 @@ t_output &i3neostatus::i3bar_protocol::impl::serialize_array_interleave(
 template <typename t_output>
 t_output &i3neostatus::i3bar_protocol::impl::serialize_string(
     t_output &output, const std::string_view string) {
-  static const std::string k_control_chars{
-      0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
-      0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
-      0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F};
-
-  static const std::unordered_map<char, std::string> k_control_char_codes{
-      {0x00, "u0000"}, {0x01, "u0001"}, {0x02, "u0002"}, {0x03, "u0003"},
-      {0x04, "u0004"}, {0x05, "u0005"}, {0x06, "u0006"}, {0x07, "u0007"},
-      {0x08, "u0008"}, {0x09, "u0009"}, {0x0A, "u000A"}, {0x0B, "u000B"},
-      {0x0C, "u000C"}, {0x0D, "u000D"}, {0x0E, "u000E"}, {0x0F, "u000F"},
-      {0x10, "u0010"}, {0x11, "u0011"}, {0x12, "u0012"}, {0x13, "u0013"},
-      {0x14, "u0014"}, {0x15, "u0015"}, {0x16, "u0016"}, {0x17, "u0017"},
-      {0x18, "u0018"}, {0x19, "u0019"}, {0x1A, "u001A"}, {0x1B, "u001B"},
-      {0x1C, "u001C"}, {0x1D, "u001D"}, {0x1E, "u001E"}, {0x1F, "u001F"}};
-
-  static const std::string k_need_to_replace{
-      k_control_chars + json_constants::k_string_delimiter +
-      json_constants::k_escape_leader};
-
-  // ret_val.reserve(string.size() + 2);
-
   output += json_constants::k_string_delimiter;
 
-  std::string::size_type pos{0};
-  std::string::size_type pos_prev{0};
-  while (true) {
-    pos = string.find_first_of(k_need_to_replace, pos_prev);
-    if (pos == std::string::npos) {
-      break;
-    } else {
-      output += string.substr(pos_prev, (pos - pos_prev));
-      output += json_constants::k_escape_leader;
-
-      switch (string[pos]) {
-      case json_constants::k_string_delimiter: {
-        output += json_constants::k_string_delimiter;
-      } break;
-      case json_constants::k_escape_leader: {
-        output += json_constants::k_escape_leader;
-      } break;
-      default: {
-        output += k_control_char_codes.at(string[pos]);
-      } break;
-      }
-
-      pos_prev = pos + 1;
-    }
+  // clean runs are copied in one go, the escapes between them come from a
+  // flat table
+  std::size_t pos_prev{0};
+  for (std::size_t pos{json_escape::find(string, 0)}; pos < string.size();
+       pos = json_escape::find(string, pos_prev)) {
+    output += string.substr(pos_prev, (pos - pos_prev));
+    output += json_escape::k_codes[static_cast<unsigned char>(string[pos])]
+                  .get();
+    pos_prev = pos + 1;
   }
   output += string.substr(pos_prev);
 
@@ -436,6 +547,21 @@ t_output &i3neostatus::i3bar_protocol::impl::serialize_string(
 
   return output;
 }
+// for the benchmarks, the other uses instantiate it implicitly
+template std::string &i3neostatus::i3bar_protocol::impl::serialize_string(
+    std::string &output, const std::string_view string);
+
+std::string &i3neostatus::i3bar_protocol::impl::serialize_text(
+    std::string &output, const std::string_view text) {
+  // the common case, valid (mostly ASCII) text, is a single scan
+  if (utf8::find_invalid(text) == text.size()) {
+    return serialize_string(output, text);
+  }
+  std::string sanitized{};
+  sanitized.reserve(text.size() + utf8::k_replacement.size());
+  utf8::sanitize(sanitized, text);
+  return serialize_string(output, sanitized);
+}
 
 template <typename t_output>
 t_output &i3neostatus::i3bar_protocol::impl::serialize_bool(t_output &output,
@@ -443,192 +569,3 @@ t_output &i3neostatus::i3bar_protocol::impl::serialize_bool(t_output &output,
   output += ((b) ? ("true") : ("false"));
   return output;
 }
-
-i3neostatus::i3bar_data::click_event
-i3neostatus::i3bar_protocol::impl::parse_click_event(
-    const std::string_view click_event) {
-  const auto substr{[](const std::string_view str,
-                       const std::string::size_type begin,
-                       const std::string::size_type end) -> std::string_view {
-    return str.substr(begin, end - begin + 1);
-  }};
-  const auto find_first_digit{
-      [](const std::string_view str,
-         const std::string::size_type pos = 0) -> std::string::size_type {
-        for (std::string::size_type i{pos}; i < str.size(); ++i) {
-          if (str[i] >= '0' && str[i] <= '9') {
-            return i;
-          }
-        }
-        return std::string::npos;
-      }};
-  const auto find_first_not_digit{
-      [](const std::string_view str,
-         const std::string::size_type pos = 0) -> std::string::size_type {
-        for (std::string::size_type i{pos}; i < str.size(); ++i) {
-          if (!(str[i] >= '0' && str[i] <= '9')) {
-            return i;
-          }
-        }
-        return std::string::npos;
-      }};
-  const auto read_string_value{
-      [&substr](const std::string_view str,
-                const std::string::size_type name_end_pos,
-                std::string::size_type &continue_from_pos) -> std::string {
-        const std::string::size_type value_begin_pos{
-            str.find(json_constants::k_string_delimiter, name_end_pos + 2) + 1};
-        const std::string::size_type value_end_pos{
-            str.find(json_constants::k_string_delimiter, value_begin_pos) - 1};
-        continue_from_pos = value_end_pos + 2;
-        return std::string{substr(str, value_begin_pos, value_end_pos)};
-      }};
-  const auto read_numeric_value{
-      [&substr, &find_first_digit, &find_first_not_digit](
-          const std::string_view str, const std::string::size_type name_end_pos,
-          std::string::size_type &continue_from_pos) -> std::string_view {
-        const std::string::size_type value_begin_pos{
-            find_first_digit(str, name_end_pos + 2)};
-        const std::string::size_type value_end_pos{
-            find_first_not_digit(str, value_begin_pos)};
-        continue_from_pos = value_end_pos + 1;
-        return substr(str, value_begin_pos, value_end_pos);
-      }};
-
-  std::string name_buf;
-  name_buf.resize(bits_and_bytes::constexpr_min_max::max(
-      json_strings::click_event::k_name.size(),
-      json_strings::click_event::k_instance.size(),
-      json_strings::click_event::k_x.size(),
-      json_strings::click_event::k_y.size(),
-      json_strings::click_event::k_button.size(),
-      json_strings::click_event::k_relative_x.size(),
-      json_strings::click_event::k_relative_y.size(),
-      json_strings::click_event::k_output_x.size(),
-      json_strings::click_event::k_output_y.size(),
-      json_strings::click_event::k_width.size(),
-      json_strings::click_event::k_height.size(),
-      json_strings::click_event::k_modifiers.size()));
-
-  i3bar_data::click_event ret_val{};
-
-  std::string::size_type continue_from_pos{0};
-
-  while (true) {
-    std::string::size_type name_begin_pos{click_event.find(
-        json_constants::k_string_delimiter, continue_from_pos)};
-    if (name_begin_pos == std::string::npos) {
-      break;
-    } else {
-      ++name_begin_pos;
-      const std::string::size_type name_end_pos =
-          (click_event.find(json_constants::k_string_delimiter,
-                            name_begin_pos) -
-           1);
-      name_buf = substr(click_event, name_begin_pos, name_end_pos);
-
-      switch (bits_and_bytes::constexpr_hash_string::hash(name_buf)) {
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_name): {
-        ret_val.id.name =
-            read_string_value(click_event, name_end_pos, continue_from_pos);
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_instance): {
-        ret_val.id.instance = plugin_id::from_string(
-            read_string_value(click_event, name_end_pos, continue_from_pos));
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_x): {
-        const std::string_view value{
-            read_numeric_value(click_event, name_end_pos, continue_from_pos)};
-        std::from_chars(value.data(), value.data() + value.size(),
-                        ret_val.data.x);
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_y): {
-        const std::string_view value{
-            read_numeric_value(click_event, name_end_pos, continue_from_pos)};
-        std::from_chars(value.data(), value.data() + value.size(),
-                        ret_val.data.y);
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_button): {
-        const std::string_view value{
-            read_numeric_value(click_event, name_end_pos, continue_from_pos)};
-        std::from_chars(value.data(), value.data() + value.size(),
-                        ret_val.data.button);
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_relative_x): {
-        const std::string_view value{
-            read_numeric_value(click_event, name_end_pos, continue_from_pos)};
-        std::from_chars(value.data(), value.data() + value.size(),
-                        ret_val.data.relative_x);
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_relative_y): {
-        const std::string_view value{
-            read_numeric_value(click_event, name_end_pos, continue_from_pos)};
-        std::from_chars(value.data(), value.data() + value.size(),
-                        ret_val.data.relative_y);
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_output_x): {
-        const std::string_view value{
-            read_numeric_value(click_event, name_end_pos, continue_from_pos)};
-        std::from_chars(value.data(), value.data() + value.size(),
-                        ret_val.data.output_x);
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_output_y): {
-        const std::string_view value{
-            read_numeric_value(click_event, name_end_pos, continue_from_pos)};
-        std::from_chars(value.data(), value.data() + value.size(),
-                        ret_val.data.output_y);
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_width): {
-        const std::string_view value{
-            read_numeric_value(click_event, name_end_pos, continue_from_pos)};
-        std::from_chars(value.data(), value.data() + value.size(),
-                        ret_val.data.width);
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_height): {
-        const std::string_view value{
-            read_numeric_value(click_event, name_end_pos, continue_from_pos)};
-        std::from_chars(value.data(), value.data() + value.size(),
-                        ret_val.data.height);
-      } break;
-      case bits_and_bytes::constexpr_hash_string::hash(
-          json_strings::click_event::k_modifiers): {
-        const std::string::size_type array_begin_pos{click_event.find(
-            json_constants::k_array_opening_delimiter, name_end_pos + 2)};
-        const std::string::size_type array_end_pos{click_event.find(
-            json_constants::k_array_closing_delimiter, array_begin_pos)};
-        if ((array_begin_pos + 1) != array_end_pos) {
-          for (std::string::size_type i{array_begin_pos}; i < array_end_pos;) {
-            const std::string::size_type value_begin_pos{
-                click_event.find(json_constants::k_string_delimiter, i) + 1};
-            const std::string::size_type value_end_pos{
-                click_event.find(json_constants::k_string_delimiter,
-                                 value_begin_pos) -
-                1};
-            ret_val.data.modifiers |= i3bar_data::types::from_string<
-                i3bar_data::types::click_modifiers>(std::string{
-                substr(click_event, value_begin_pos, value_end_pos)});
-            i = value_end_pos + 2;
-          }
-        }
-        continue_from_pos = array_end_pos + 1;
-      } break;
-      default: {
-        throw bits_and_bytes::unreachable_error{};
-      } break;
-      }
-    }
-  }
-
-  return ret_val;
-}
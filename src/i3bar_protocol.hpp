@@ -2,16 +2,24 @@
 #define I3NEOSTATUS_I3BAR_PROTOCOL_HPP
 
 #include "i3bar_data.hpp"
+#include "plugin_id.hpp"
+#include "statusline_writer.hpp"
 
 #include "bits-and-bytes/stream_append.hpp"
 
+#include <array>
+#include <charconv>
 #include <concepts>
+#include <cstddef>
 #include <iostream>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include <sys/uio.h>
+
 namespace i3neostatus {
 
 namespace i3bar_protocol {
@@ -83,31 +91,41 @@ void print_statusline(const std::vector<struct i3bar_data::block> &content,
                       const std::vector<i3bar_data::block> &separators,
                       const bool hide_empty, std::ostream &stream = std::cout);
 
-void print_statusline(const struct i3bar_data::block &content,
-                      const plugin_id::type content_index,
-                      std::vector<std::string> &content_cache,
-                      const bool hide_empty, std::ostream &stream = std::cout);
-void print_statusline(const struct i3bar_data::block &content,
-                      const plugin_id::type content_index,
-                      std::vector<std::string> &content_cache,
-                      const i3bar_data::block &separator_left,
-                      const plugin_id::type separator_left_index,
-                      const i3bar_data::block &separator_right,
-                      const plugin_id::type separator_right_index,
-                      std::vector<std::string> &separator_cache,
-                      const bool hide_empty, std::ostream &stream = std::cout);
-
-void print_statusline(const std::vector<struct i3bar_data::block> &content,
-                      std::vector<std::string> &content_cache,
-                      const bool hide_empty, std::ostream &stream = std::cout);
-void print_statusline(const std::vector<struct i3bar_data::block> &content,
-                      std::vector<std::string> &content_cache,
-                      const std::vector<i3bar_data::block> &separators,
-                      std::vector<std::string> &separator_cache,
-                      const bool hide_empty, std::ostream &stream = std::cout);
-
-void init_click_event(std::istream &input_stream = std::cin);
-i3bar_data::click_event read_click_event(std::istream &input_stream = std::cin);
+void update_statusline(const struct i3bar_data::block &content,
+                       const plugin_id::type content_index,
+                       std::vector<std::string> &content_cache,
+                       const bool hide_empty);
+void update_statusline(const struct i3bar_data::block &content,
+                       const plugin_id::type content_index,
+                       std::vector<std::string> &content_cache,
+                       const i3bar_data::block &separator_left,
+                       const plugin_id::type separator_left_index,
+                       const i3bar_data::block &separator_right,
+                       const plugin_id::type separator_right_index,
+                       std::vector<std::string> &separator_cache,
+                       const bool hide_empty);
+
+void update_statusline(const std::vector<struct i3bar_data::block> &content,
+                       std::vector<std::string> &content_cache,
+                       const bool hide_empty);
+void update_statusline(const std::vector<struct i3bar_data::block> &content,
+                       std::vector<std::string> &content_cache,
+                       const std::vector<i3bar_data::block> &separators,
+                       std::vector<std::string> &separator_cache,
+                       const bool hide_empty);
+
+// the global and theme members of a block as serialize_block() writes them,
+// for i3bar_data::block::data::program::serialized
+std::string
+serialize_program(const struct i3bar_data::block::data::program &program);
+
+// returns false if the frame could not be written completely, see
+// statusline_writer::write()
+bool print_statusline(const std::vector<std::string> &content_cache,
+                      const bool hide_empty, statusline_writer &writer);
+bool print_statusline(const std::vector<std::string> &content_cache,
+                      const std::vector<std::string> &separator_cache,
+                      const bool hide_empty, statusline_writer &writer);
 
 namespace impl {
 void print_statusline(const std::vector<std::string> &content,
@@ -115,13 +133,70 @@ void print_statusline(const std::vector<std::string> &content,
 void print_statusline(const std::vector<std::string> &content,
                       const std::vector<std::string> &separators,
                       const bool hide_empty, std::ostream &stream = std::cout);
+bool print_statusline(const std::vector<std::string> &content,
+                      const bool hide_empty, statusline_writer &writer);
+bool print_statusline(const std::vector<std::string> &content,
+                      const std::vector<std::string> &separators,
+                      const bool hide_empty, statusline_writer &writer);
+
+// output for the serialize_*() templates that gathers pointers to the
+// serialized strings instead of copying them, the strings have to outlive the
+// use of get()
+class iovec_output {
+private:
+  static constexpr std::array<char, 256> m_k_chars{[]() {
+    std::array<char, 256> chars{};
+    for (std::size_t i{0}; i < chars.size(); ++i) {
+      chars[i] = static_cast<char>(i);
+    }
+    return chars;
+  }()};
+
+private:
+  std::vector<iovec> m_iovecs;
+
+public:
+  iovec_output();
+  iovec_output(iovec_output &&other) noexcept;
+  iovec_output(const iovec_output &other);
+
+public:
+  ~iovec_output();
+
+public:
+  iovec_output &operator=(iovec_output &&other) noexcept;
+  iovec_output &operator=(const iovec_output &other);
+
+public:
+  iovec_output &operator+=(const std::string &string);
+  iovec_output &operator+=(const char c);
+
+  void clear();
+  std::span<iovec> get();
+};
 
 template <typename t_output>
 t_output &serialize_header(t_output &output, const i3bar_data::header &header);
-template <typename t_output>
-t_output &serialize_block(t_output &output,
-                          const struct i3bar_data::block &block,
-                          const bool hide_empty);
+// one member of the serialized block object. key holds the quoted name and
+// the colon, preceded by the opening brace (first field) or a comma (all
+// others), so that a block is the concatenation of its present fields
+struct block_field {
+  std::string_view key;
+  // nullptr for members that are always present
+  bool (*present)(const struct i3bar_data::block &block);
+  void (*value)(std::string &output, const struct i3bar_data::block &block);
+};
+
+// appends the members of block (only those of block.data.program if
+// t_program_only) without any intermediate strings, driven by a compile-time
+// table of block_field
+template <bool t_program_only>
+std::string &serialize_block_fields(std::string &output,
+                                    const struct i3bar_data::block &block);
+// writes block.data.program.serialized in place of the members it covers
+std::string &serialize_block(std::string &output,
+                             const struct i3bar_data::block &block,
+                             const bool hide_empty);
 std::vector<std::string>
 serialize_blocks(const std::vector<struct i3bar_data::block> &blocks,
                  const bool hide_empty);
@@ -148,15 +223,25 @@ t_output &serialize_number(t_output &output, auto number)
            std::floating_point<decltype(number)>)
 {
   using namespace bits_and_bytes::stream_append;
-  output += std::to_string(number);
+  if constexpr (std::integral<decltype(number)>) {
+    // enough for any 64-bit integer, without the temporary of to_string()
+    std::array<char, 24> buf;
+    const std::to_chars_result result{
+        std::to_chars(buf.data(), (buf.data() + buf.size()), number)};
+    output += std::string_view{buf.data(), result.ptr};
+  } else {
+    output += std::to_string(number);
+  }
   return output;
 }
 template <typename t_output>
 t_output &serialize_string(t_output &output, const std::string_view string);
+// serialize_string() for displayed text, ill-formed UTF-8 is replaced so
+// that i3bar does not reject the whole statusline. plugin text has already
+// been sanitized (and counted) when it was applied, this covers the rest
+std::string &serialize_text(std::string &output, const std::string_view text);
 template <typename t_output>
 t_output &serialize_bool(t_output &output, const bool b);
-
-i3bar_data::click_event parse_click_event(const std::string_view click_event);
 } // namespace impl
 } // namespace i3bar_protocol
 } // namespace i3neostatus
@@ -0,0 +1,93 @@
+#include "json_escape.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <string_view>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+std::size_t i3neostatus::json_escape::find(const std::string_view string,
+                                           const std::size_t pos) {
+  static const impl::find_func k_find{impl::select()};
+  return k_find(string, pos);
+}
+
+i3neostatus::json_escape::impl::find_func
+i3neostatus::json_escape::impl::select() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  return ((__builtin_cpu_supports("avx2")) ? (&find_avx2) : (&find_sse2));
+#else
+  return &find_scalar;
+#endif
+}
+
+std::size_t
+i3neostatus::json_escape::impl::find_scalar(const std::string_view string,
+                                            const std::size_t pos) {
+  for (std::size_t i{pos}; i < string.size(); ++i) {
+    if (k_codes[static_cast<unsigned char>(string[i])].size != 0) {
+      return i;
+    }
+  }
+  return string.size();
+}
+
+#if defined(__x86_64__)
+// a character has to be escaped if it is <= 0x1F (compared unsigned, through
+// min, so that UTF-8 continuation bytes are not matched), '"' or '\\'
+
+std::size_t
+i3neostatus::json_escape::impl::find_sse2(const std::string_view string,
+                                          const std::size_t pos) {
+  static constexpr std::size_t k_width{sizeof(__m128i)};
+  const __m128i control_max{_mm_set1_epi8(0x1F)};
+  const __m128i delimiter{_mm_set1_epi8('"')};
+  const __m128i escape_leader{_mm_set1_epi8('\\')};
+
+  std::size_t i{pos};
+  for (; (i + k_width) <= string.size(); i += k_width) {
+    const __m128i chars{
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(string.data() + i))};
+    const __m128i matches{_mm_or_si128(
+        _mm_cmpeq_epi8(_mm_min_epu8(chars, control_max), chars),
+        _mm_or_si128(_mm_cmpeq_epi8(chars, delimiter),
+                     _mm_cmpeq_epi8(chars, escape_leader)))};
+    const unsigned int mask{
+        static_cast<unsigned int>(_mm_movemask_epi8(matches))};
+    if (mask != 0) {
+      return (i + std::countr_zero(mask));
+    }
+  }
+  return find_scalar(string, i);
+}
+
+__attribute__((target("avx2"))) std::size_t
+i3neostatus::json_escape::impl::find_avx2(const std::string_view string,
+                                          const std::size_t pos) {
+  static constexpr std::size_t k_width{sizeof(__m256i)};
+  const __m256i control_max{_mm256_set1_epi8(0x1F)};
+  const __m256i delimiter{_mm256_set1_epi8('"')};
+  const __m256i escape_leader{_mm256_set1_epi8('\\')};
+
+  std::size_t i{pos};
+  for (; (i + k_width) <= string.size(); i += k_width) {
+    const __m256i chars{_mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(string.data() + i))};
+    const __m256i matches{_mm256_or_si256(
+        _mm256_cmpeq_epi8(_mm256_min_epu8(chars, control_max), chars),
+        _mm256_or_si256(_mm256_cmpeq_epi8(chars, delimiter),
+                        _mm256_cmpeq_epi8(chars, escape_leader)))};
+    const unsigned int mask{
+        static_cast<unsigned int>(_mm256_movemask_epi8(matches))};
+    if (mask != 0) {
+      return (i + std::countr_zero(mask));
+    }
+  }
+  // not find_sse2(), mixing in legacy SSE code costs more than the few
+  // remaining characters
+  return find_scalar(string, i);
+}
+#endif
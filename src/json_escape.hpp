@@ -0,0 +1,52 @@
+#ifndef I3NEOSTATUS_JSON_ESCAPE_HPP
+#define I3NEOSTATUS_JSON_ESCAPE_HPP
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace i3neostatus {
+namespace json_escape {
+struct code {
+  std::array<char, 6> chars;
+  std::size_t size; // zero if the character is copied as is
+
+  constexpr std::string_view get() const { return {chars.data(), size}; }
+};
+
+// indexed by the character as unsigned char: control characters become
+// \u00XX, the string delimiter and the escape leader get a backslash
+inline constexpr std::array<code, 256> k_codes{[]() {
+  constexpr std::string_view k_hex_digits{"0123456789ABCDEF"};
+  std::array<code, 256> codes{};
+  for (std::size_t i{0}; i < 0x20; ++i) {
+    codes[i] = {{'\\', 'u', '0', '0', k_hex_digits[i >> 4],
+                 k_hex_digits[i & 0xF]},
+                6};
+  }
+  codes['"'] = {{'\\', '"'}, 2};
+  codes['\\'] = {{'\\', '\\'}, 2};
+  return codes;
+}()};
+
+// index of the first character at or after pos that has to be escaped,
+// string.size() if there is none. scans 32 (AVX2, if the cpu supports it) or
+// 16 (SSE2) characters at a time on x86-64
+std::size_t find(const std::string_view string, const std::size_t pos);
+
+namespace impl {
+using find_func = std::size_t (*)(const std::string_view string,
+                                  const std::size_t pos);
+
+find_func select();
+
+std::size_t find_scalar(const std::string_view string, const std::size_t pos);
+#if defined(__x86_64__)
+std::size_t find_sse2(const std::string_view string, const std::size_t pos);
+std::size_t find_avx2(const std::string_view string, const std::size_t pos);
+#endif
+} // namespace impl
+} // namespace json_escape
+} // namespace i3neostatus
+
+#endif
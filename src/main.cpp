@@ -1,15 +1,27 @@
+#include "block_hash.hpp"
 #include "block_state.hpp"
 #include "click_event_listener.hpp"
 #include "config_file.hpp"
+#include "coro_executor.hpp"
+#include "event_loop.hpp"
+#include "frame_scheduler.hpp"
 #include "hide_block.hpp"
 #include "i3bar_data.hpp"
 #include "i3bar_protocol.hpp"
 #include "make_block.hpp"
 #include "message_printing.hpp"
+#include "metrics.hpp"
 #include "plugin_api.hpp"
 #include "plugin_error.hpp"
 #include "plugin_handle.hpp"
 #include "plugin_id.hpp"
+#include "poll_pool.hpp"
+#include "statusline_writer.hpp"
+#include "thread_comm.hpp"
+#include "timer_wheel.hpp"
+#include "update_queue.hpp"
+#include "utf8.hpp"
+#include "visible_index.hpp"
 
 #include "bits-and-bytes/constexpr_hash_string.hpp"
 #include "bits-and-bytes/unreachable_error.hpp"
@@ -17,141 +29,20 @@
 #include <algorithm>
 #include <atomic>
 #include <csignal>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
-#include <mutex>
+#include <optional>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 
-using namespace i3neostatus;
-
-class update_queue {
-public:
-  struct update_info {
-    plugin_id::type id;
-    class update_queue *update_queue;
-    std::atomic<bool> is_buffered;
-
-    explicit update_info(plugin_id::type id,
-                         class update_queue *update_queue = nullptr,
-                         std::atomic<bool> is_buffered = false)
-        : id{id}, update_queue{update_queue}, is_buffered{is_buffered.load()} {}
-
-    update_info(const update_info &other)
-        : id{other.id}, update_queue{other.update_queue},
-          is_buffered{other.is_buffered.load()} {}
-
-    update_info(update_info &&other) noexcept
-        : id{other.id}, update_queue{other.update_queue},
-          is_buffered{other.is_buffered.load()} {
-      other.id = plugin_id::null;
-      other.update_queue = nullptr;
-      other.is_buffered.store(false);
-    }
-
-    ~update_info() = default;
-
-    update_info &operator=(const update_info &other) {
-      if (this != &other) {
-        id = other.id;
-        update_queue = other.update_queue;
-        is_buffered.store(other.is_buffered.load());
-      }
-      return *this;
-    }
-
-    update_info &operator=(update_info &&other) noexcept {
-      if (this != &other) {
-        id = other.id;
-        update_queue = other.update_queue;
-        is_buffered.store(other.is_buffered.load());
-
-        other.id = plugin_id::null;
-        other.update_queue = nullptr;
-        other.is_buffered.store(false);
-      }
-      return *this;
-    }
-  };
-
-private:
-  std::size_t m_capacity;
-  plugin_id::type *m_buffer;
-  std::atomic<std::size_t> m_count;
-  std::size_t m_write;
-  std::mutex m_write_mtx;
-  std::size_t m_read;
-
-public:
-  explicit update_queue(std::size_t capacity)
-      : m_capacity{capacity}, m_buffer{new plugin_id::type[m_capacity]{}},
-        m_count{0}, m_write{0}, m_read{0} {
-    std::fill(m_buffer, m_buffer + m_capacity, plugin_id::null);
-  }
-
-  update_queue(update_queue &&other) noexcept
-      : m_capacity{other.m_capacity}, m_buffer{other.m_buffer},
-        m_count{other.m_count.load()}, m_write{other.m_write},
-        m_read{other.m_read} {
-    other.m_capacity = 0;
-    other.m_buffer = nullptr;
-    other.m_count = 0;
-    other.m_write = 0;
-    other.m_read = 0;
-  }
-
-  update_queue(const update_queue &other) = delete;
-
-  ~update_queue() { delete[] m_buffer; }
-
-  update_queue &operator=(update_queue &&other) noexcept {
-    if (this != &other) {
-      delete[] m_buffer;
-
-      m_capacity = other.m_capacity;
-      m_buffer = other.m_buffer;
-      m_count.store(other.m_count.load());
-      m_write = other.m_write;
-      m_read = other.m_read;
-
-      other.m_capacity = 0;
-      other.m_buffer = nullptr;
-      other.m_count.store(0);
-      other.m_write = 0;
-      other.m_read = 0;
-    }
-    return *this;
-  }
-
-  update_queue &operator=(const update_queue &other) = delete;
-
-public:
-  void put(const plugin_id::type id) {
-    {
-      const std::lock_guard<std::mutex> lock_m_write_mtx{m_write_mtx};
-      m_buffer[m_write] = id;
-      m_write = inc_and_mod(m_write);
-    }
-    ++m_count;
-    m_count.notify_all();
-  }
-
-  plugin_id::type get() {
-    const plugin_id::type id{m_buffer[m_read]};
-    m_read = inc_and_mod(m_read);
-    --m_count;
-    m_count.notify_all();
-    return id;
-  }
-
-  const std::atomic<std::size_t> &count() const { return m_count; }
+#include <sys/epoll.h>
+#include <unistd.h>
 
-private:
-  std::size_t inc_and_mod(const std::size_t i) const {
-    return ((i + 1) % m_capacity);
-  }
-};
+using namespace i3neostatus;
 
 int main(int argc, char *argv[]) {
   try {
@@ -204,7 +95,25 @@ int main(int argc, char *argv[]) {
     }
     const plugin_id::type plugin_count{config.plugins.size()};
     bool click_events_enabled{false};
-
+    metrics::init(plugin_count);
+
+    // advertised to i3bar instead of SIGSTOP/SIGCONT, so that a hidden bar
+    // pauses the plugins instead of freezing the whole process
+    constexpr int stop_signal{SIGUSR1};
+    constexpr int cont_signal{SIGUSR2};
+    bool output_stopped{false};
+
+    signal_fd::block({metrics::dump_signal(), stop_signal, cont_signal});
+
+    // declared before the handles so that it outlives their channels
+    thread_comm::shared_state_arena<plugin_api::block> comm_arena{
+        plugin_count};
+    // run every timer and coroutine/poll plugin, must outlive the handles as
+    // well
+    timer_wheel timer_wheel{config.general.timer_slack};
+    coro_executor coro_executor{plugin_count};
+    poll_pool poll_pool{timer_wheel, config.general.poll_threads,
+                        plugin_count};
     std::vector<plugin_handle> plugin_handles{};
     plugin_handles.reserve(plugin_count);
     std::vector<update_queue::update_info> plugin_updates{};
@@ -215,22 +124,30 @@ int main(int argc, char *argv[]) {
         content_cache{std::piecewise_construct, std::forward_as_tuple(),
                       std::forward_as_tuple(plugin_count, block_state::idle)};
     content_cache.first.reserve(plugin_count);
-    std::vector<plugin_id::type> plugin_id_to_active_index(plugin_count,
-                                                           plugin_id::null);
-    std::vector<plugin_id::type> active_index_to_plugin_id(plugin_count,
-                                                           plugin_id::null);
-
-    std::vector<std::string> content_string_cache(plugin_count);
+    // nullopt while the cached block did not come from the plugin itself
+    std::vector<std::optional<std::size_t>> content_hash_cache(plugin_count,
+                                                               std::nullopt);
+    visible_index visible_index{plugin_count};
+
+    // every theme a block or separator can get, already serialized
+    const make_block::theme_table theme_table{
+        config.theme, config.general.custom_separators};
+    const bool alternating_tint{theme_table.has_alternating_tint()};
+
+    // every block starts out hidden, visibility changes only reserialize the
+    // entries around the changed block
+    std::vector<std::string> content_string_cache(
+        plugin_count, hide_block::set<std::string>());
     std::vector<std::string> separator_string_cache(
-        (config.general.custom_separators) ? (plugin_count + 1) : (0));
+        ((config.general.custom_separators) ? (plugin_count + 1) : (0)),
+        hide_block::set<std::string>());
 
     const auto plugin_callback{
         [](void *userdata,
            [[maybe_unused]] plugin_handle::state_change_type state) -> void {
           update_queue::update_info *plugin_update{
               static_cast<update_queue::update_info *>(userdata)};
-          if (!plugin_update->is_buffered.load()) {
-            plugin_update->is_buffered.store(true);
+          if (!plugin_update->is_buffered.exchange(true)) {
             plugin_update->update_queue->put(plugin_update->id);
           }
         }};
@@ -241,12 +158,16 @@ int main(int argc, char *argv[]) {
       plugin_handles.emplace_back(
           cur_plugin_id, std::move(config.plugins[cur_plugin_id].path_or_name),
           std::move(config.plugins[cur_plugin_id].config),
+          config.plugins[cur_plugin_id].history_depth,
+          config.plugins[cur_plugin_id].history_drop,
+          config.plugins[cur_plugin_id].click_depth,
+          config.plugins[cur_plugin_id].click_drop, comm_arena, timer_wheel,
           plugin_handle::state_change_callback{plugin_callback,
                                                &plugin_updates.back()});
       click_events_enabled =
           (click_events_enabled ||
            plugin_handles[cur_plugin_id].get_click_events_enabled());
-      plugin_handles.back().run();
+      plugin_handles.back().run(coro_executor, poll_pool);
       content_cache.first.emplace_back(i3bar_data::block{
           .id{.name{std::visit(
                   [](auto &&path_or_name) {
@@ -258,226 +179,360 @@ int main(int argc, char *argv[]) {
               hide_block::set<struct i3bar_data::block::data::plugin>()}}});
     }
 
-    click_event_listener click_event_listener{&plugin_handles, &std::cin};
+    click_event_listener click_event_listener{&plugin_handles, STDIN_FILENO};
     if (click_events_enabled) {
       click_event_listener.run();
     }
 
-    i3bar_protocol::print_header({1, SIGSTOP, SIGCONT, click_events_enabled});
+    frame_scheduler frame_scheduler{config.general.max_frame_rate,
+                                    config.general.frame_coalescing_window};
+
+    i3bar_protocol::print_header(
+        {1, stop_signal, cont_signal, click_events_enabled});
     i3bar_protocol::init_statusline();
+    // only after the header, which is written through std::cout
+    statusline_writer statusline_writer{STDOUT_FILENO};
+
+    enum class event_source : std::uint32_t {
+      update_queue,
+      frame_timer,
+      signal,
+      output,
+    };
+    event_loop event_loop{};
+    timer_fd frame_timer{};
+    signal_fd signal_fd{metrics::dump_signal(), stop_signal, cont_signal};
+    event_loop.add(update_queue.get_fd(), EPOLLIN,
+                   static_cast<std::uint32_t>(event_source::update_queue));
+    event_loop.add(frame_timer.get_fd(), EPOLLIN,
+                   static_cast<std::uint32_t>(event_source::frame_timer));
+    event_loop.add(signal_fd.get_fd(), EPOLLIN,
+                   static_cast<std::uint32_t>(event_source::signal));
+
+    // plugins with a history that still have queued blocks, each block gets
+    // its own frame so these are only re-posted once the frame is written
+    std::vector<plugin_id::type> history_pending{};
+    history_pending.reserve(plugin_count);
+    // plugins whose traced click (see metrics::block_applied()) is shown by
+    // the next frame
+    std::vector<plugin_id::type> clicks_traced{};
+    clicks_traced.reserve(plugin_count);
+
+    const auto apply_update{[&](const plugin_id::type cur_plugin_id) -> void {
+      // cleared before the take, so that a put after it queues the id again.
+      // one racing with it is taken here and finds nothing when its id comes
+      // up, which must not block the main loop
+      plugin_updates[cur_plugin_id].is_buffered.store(false);
+      std::optional<std::variant<plugin_api::block, std::exception_ptr>>
+          taken{plugin_handles[cur_plugin_id].get_comm().try_get()};
+      if (!taken.has_value()) {
+        return;
+      }
+      std::variant<plugin_api::block, std::exception_ptr> &content_plugin{
+          *taken};
+      metrics::global.updates_received.fetch_add(1, std::memory_order_relaxed);
+
+      const bool hide_previous{
+          hide_block::get(content_cache.first[cur_plugin_id])};
+      // keeping is_buffered set stops later puts from queueing the id twice
+      if (plugin_handles[cur_plugin_id].get_comm().pending() &&
+          (!plugin_updates[cur_plugin_id].is_buffered.exchange(true))) {
+        history_pending.push_back(cur_plugin_id);
+      }
 
-    while (true) {
-      update_queue.count().wait(0);
-      for (std::size_t queued_updates{update_queue.count().load()},
-           cur_queued_update{};
-           cur_queued_update < queued_updates; ++cur_queued_update) {
-        const plugin_id::type cur_plugin_id{update_queue.get()};
-        plugin_updates[cur_plugin_id].is_buffered.store(false);
-
-        const bool hide_previous{
-            hide_block::get(content_cache.first[cur_plugin_id])};
-        std::variant<plugin_api::block, std::exception_ptr> content_plugin{
-            plugin_handles[cur_plugin_id].get_comm().get()};
-
-        switch (content_plugin.index()) {
-        case 0: {
-          std::tie(content_cache.first[cur_plugin_id].data.plugin,
-                   content_cache.second[cur_plugin_id]) =
-              std::get<0>(std::move(content_plugin));
-        } break;
-        case 1: {
-          try {
-            std::rethrow_exception(std::get<1>(std::move(content_plugin)));
-          } catch (const std::exception &exception) {
-            content_cache.first[cur_plugin_id].data.plugin = {
-                .full_text{plugin_error{
-                    cur_plugin_id,
-                    plugin_handles[cur_plugin_id].get_path_or_name(),
-                    exception.what()}
-                               .what()},
-                .short_text{std::nullopt},
-                .min_width{std::nullopt},
-                .align{std::nullopt},
-                .urgent{true},
-                .markup{i3bar_data::types::markup::none}};
-            content_cache.second[cur_plugin_id] = block_state::error;
-          }
-        } break;
-        default: {
-          throw bits_and_bytes::unreachable_error{};
-        } break;
+      switch (content_plugin.index()) {
+      case 0: {
+        plugin_api::block &new_block{std::get<0>(content_plugin)};
+        // sanitized once here, so that re-serializing the cached block (for
+        // a new theme, tint or separator) does not count it again
+        bool invalid_utf8{
+            utf8::sanitize_in_place(new_block.first.full_text)};
+        if (new_block.first.short_text.has_value()) {
+          invalid_utf8 =
+              (utf8::sanitize_in_place(*new_block.first.short_text) ||
+               invalid_utf8);
+        }
+        if (new_block.first.min_width.has_value() &&
+            (new_block.first.min_width->index() == 1)) {
+          invalid_utf8 = (utf8::sanitize_in_place(
+                              std::get<1>(*new_block.first.min_width)) ||
+                          invalid_utf8);
+        }
+        if (invalid_utf8) {
+          metrics::plugins[cur_plugin_id].invalid_utf8.fetch_add(
+              1, std::memory_order_relaxed);
+        }
+        const std::size_t new_hash{block_hash::get(new_block)};
+        if ((content_hash_cache[cur_plugin_id] == new_hash) &&
+            (content_cache.second[cur_plugin_id] == new_block.second) &&
+            (content_cache.first[cur_plugin_id].data.plugin ==
+             new_block.first)) {
+          metrics::plugins[cur_plugin_id].updates_suppressed.fetch_add(
+              1, std::memory_order_relaxed);
+          metrics::block_suppressed(cur_plugin_id);
+          return;
+        }
+        content_hash_cache[cur_plugin_id] = new_hash;
+        std::tie(content_cache.first[cur_plugin_id].data.plugin,
+                 content_cache.second[cur_plugin_id]) = std::move(new_block);
+        if (metrics::block_applied(cur_plugin_id)) {
+          clicks_traced.push_back(cur_plugin_id);
         }
+      } break;
+      case 1: {
+        try {
+          std::rethrow_exception(std::get<1>(std::move(content_plugin)));
+        } catch (const std::exception &exception) {
+          content_cache.first[cur_plugin_id].data.plugin = {
+              .full_text{plugin_error{
+                  cur_plugin_id,
+                  plugin_handles[cur_plugin_id].get_path_or_name(),
+                  exception.what()}
+                             .what()},
+              .short_text{std::nullopt},
+              .min_width{std::nullopt},
+              .align{std::nullopt},
+              .urgent{true},
+              .markup{i3bar_data::types::markup::none}};
+          content_cache.second[cur_plugin_id] = block_state::error;
+          content_hash_cache[cur_plugin_id] = std::nullopt;
+        }
+      } break;
+      default: {
+        throw bits_and_bytes::unreachable_error{};
+      } break;
+      }
 
-        const bool hide_current{
-            hide_block::get(content_cache.first[cur_plugin_id])};
-
-        const auto make_separator_left{
-            [&config, &content_cache, &plugin_id_to_active_index,
-             &active_index_to_plugin_id](const plugin_id::type cur_plugin_id)
-                -> std::pair<i3bar_data::block, plugin_id::type> {
-              if (cur_plugin_id == plugin_id::null) {
-                return {i3bar_data::block{.data{.plugin{hide_block::set<
-                            struct i3bar_data::block::data::plugin>()}}},
-                        plugin_id::null};
-              }
-              const plugin_id::type left_plugin_id{
-                  ((plugin_id_to_active_index[cur_plugin_id] != 0)
-                       ? (active_index_to_plugin_id
-                              [plugin_id_to_active_index[cur_plugin_id] - 1])
-                       : (plugin_id::null))};
-              return {
-                  make_block::separator(
-                      config.theme,
-                      ((left_plugin_id != plugin_id::null)
-                           ? (&content_cache.first[left_plugin_id]
-                                   .data.program.theme)
-                           : (nullptr)),
-                      &content_cache.first[cur_plugin_id].data.program.theme),
-                  cur_plugin_id};
-            }};
-        const auto make_separator_right{
-            [&config, plugin_count, &content_cache, &plugin_id_to_active_index,
-             &active_index_to_plugin_id](const plugin_id::type cur_plugin_id)
-                -> std::pair<i3bar_data::block, plugin_id::type> {
-              if (cur_plugin_id == plugin_id::null) {
-                return {i3bar_data::block{.data{.plugin{hide_block::set<
-                            struct i3bar_data::block::data::plugin>()}}},
-                        plugin_id::null};
-              }
-              const plugin_id::type right_plugin_id{
-                  ((((plugin_id_to_active_index[cur_plugin_id] + 1 <
-                      plugin_count)) &&
-                    (active_index_to_plugin_id
-                         [plugin_id_to_active_index[cur_plugin_id] + 1] !=
-                     plugin_id::null))
-                       ? (active_index_to_plugin_id
-                              [plugin_id_to_active_index[cur_plugin_id] + 1])
-                       : (plugin_id::null))};
-              return {
-                  make_block::separator(
-                      config.theme,
-                      &content_cache.first[cur_plugin_id].data.program.theme,
-                      ((right_plugin_id != plugin_id::null)
-                           ? (&content_cache.first[right_plugin_id]
-                                   .data.program.theme)
-                           : (nullptr))),
-                  ((right_plugin_id != plugin_id::null) ? (right_plugin_id)
-                                                        : (plugin_count))};
-            }};
-        const auto make_separators{
-            [&make_separator_left,
-             &make_separator_right](const plugin_id::type cur_plugin_id)
-                -> std::pair<decltype(make_separator_left(cur_plugin_id)),
-                             decltype(make_separator_right(cur_plugin_id))> {
-              return {make_separator_left(cur_plugin_id),
-                      make_separator_right(cur_plugin_id)};
-            }};
-
-        if (hide_previous != hide_current) {
-          if (hide_current) {
-            for (plugin_id::type i{plugin_id_to_active_index[cur_plugin_id]};
-                 i < (plugin_count - 1); ++i) {
-              active_index_to_plugin_id[i] = active_index_to_plugin_id[i + 1];
+      const bool hide_current{
+          hide_block::get(content_cache.first[cur_plugin_id])};
+
+      const auto make_separator_left{
+          [&theme_table, &content_cache,
+           &visible_index](const plugin_id::type cur_plugin_id)
+              -> std::pair<const i3bar_data::block *, plugin_id::type> {
+            if (cur_plugin_id == plugin_id::null) {
+              return {&theme_table.hidden_separator(), plugin_id::null};
+            }
+            const plugin_id::type left_plugin_id{
+                visible_index.previous(cur_plugin_id)};
+            return {&theme_table.separator(
+                        ((left_plugin_id != plugin_id::null)
+                             ? (&content_cache.first[left_plugin_id]
+                                     .data.program)
+                             : (nullptr)),
+                        &content_cache.first[cur_plugin_id].data.program),
+                    cur_plugin_id};
+          }};
+      const auto make_separator_right{
+          [&theme_table, plugin_count, &content_cache,
+           &visible_index](const plugin_id::type cur_plugin_id)
+              -> std::pair<const i3bar_data::block *, plugin_id::type> {
+            if (cur_plugin_id == plugin_id::null) {
+              return {&theme_table.hidden_separator(), plugin_id::null};
+            }
+            const plugin_id::type right_plugin_id{
+                visible_index.next(cur_plugin_id)};
+            return {&theme_table.separator(
+                        &content_cache.first[cur_plugin_id].data.program,
+                        ((right_plugin_id != plugin_id::null)
+                             ? (&content_cache.first[right_plugin_id]
+                                     .data.program)
+                             : (nullptr))),
+                    ((right_plugin_id != plugin_id::null) ? (right_plugin_id)
+                                                          : (plugin_count))};
+          }};
+      const auto make_separators{
+          [&make_separator_left,
+           &make_separator_right](const plugin_id::type cur_plugin_id)
+              -> std::pair<decltype(make_separator_left(cur_plugin_id)),
+                           decltype(make_separator_right(cur_plugin_id))> {
+            return {make_separator_left(cur_plugin_id),
+                    make_separator_right(cur_plugin_id)};
+          }};
+
+      if (hide_previous != hide_current) {
+        visible_index.set(cur_plugin_id, (!hide_current));
+
+        if (!hide_current) {
+          content_cache.first[cur_plugin_id].data.program =
+              theme_table.content(
+                  content_cache.second[cur_plugin_id],
+                  ((visible_index.position(cur_plugin_id) % 2) != 0));
+        }
+        i3bar_protocol::update_statusline(content_cache.first[cur_plugin_id],
+                                          cur_plugin_id, content_string_cache,
+                                          true);
+        // only the blocks after the changed one moved, which flips their
+        // alternating tint
+        if (alternating_tint) {
+          for (plugin_id::type i{cur_plugin_id + 1},
+               position{visible_index.position(i)};
+               i < plugin_count; ++i) {
+            if (visible_index.is_visible(i)) {
+              content_cache.first[i].data.program = theme_table.content(
+                  content_cache.second[i], ((position % 2) != 0));
+              i3bar_protocol::update_statusline(content_cache.first[i], i,
+                                                content_string_cache, true);
+              ++position;
             }
-            active_index_to_plugin_id.back() = plugin_id::null;
+          }
+        }
+
+        if (config.general.custom_separators) {
+          // slot i is the separator left of plugin i (hidden along with it),
+          // slot plugin_count is the one right of the last visible plugin
+          const auto update_separator{[&](const plugin_id::type slot) -> void {
+            i3bar_protocol::update_statusline(
+                *((slot == plugin_count)
+                      ? (make_separator_right(visible_index.last()).first)
+                      : (make_separator_left(((visible_index.is_visible(slot))
+                                                  ? (slot)
+                                                  : (plugin_id::null)))
+                             .first)),
+                slot, separator_string_cache, true);
+          }};
+
+          update_separator(cur_plugin_id);
+          if (alternating_tint) {
             for (plugin_id::type i{cur_plugin_id + 1}; i < plugin_count; ++i) {
-              if (plugin_id_to_active_index[i] != plugin_id::null) {
-                --plugin_id_to_active_index[i];
+              if (visible_index.is_visible(i)) {
+                update_separator(i);
               }
             }
-            plugin_id_to_active_index[cur_plugin_id] = plugin_id::null;
+            update_separator(plugin_count);
           } else {
-            for (plugin_id::type i{0};; ++i) {
-              if ((active_index_to_plugin_id[i] > cur_plugin_id) ||
-                  (active_index_to_plugin_id[i] == plugin_id::null)) {
-                for (plugin_id::type j{plugin_count}; (j--) > (i + 1);) {
-                  active_index_to_plugin_id[j] =
-                      active_index_to_plugin_id[j - 1];
-                }
-                active_index_to_plugin_id[i] = cur_plugin_id;
-                for (plugin_id::type j{cur_plugin_id + 1}; j < plugin_count;
-                     ++j) {
-                  if (plugin_id_to_active_index[j] != plugin_id::null) {
-                    ++plugin_id_to_active_index[j];
-                  }
-                }
-                plugin_id_to_active_index[cur_plugin_id] = i;
-                break;
-              }
-            }
+            const plugin_id::type next_plugin_id{
+                visible_index.next(cur_plugin_id)};
+            update_separator((next_plugin_id != plugin_id::null)
+                                 ? (next_plugin_id)
+                                 : (plugin_count));
           }
+        }
+        frame_scheduler.add_change();
+
+      } else if (!hide_current) {
+        content_cache.first[cur_plugin_id].data.program = theme_table.content(
+            content_cache.second[cur_plugin_id],
+            ((visible_index.position(cur_plugin_id) % 2) != 0));
+
+        if (config.general.custom_separators) {
+          const std::pair<
+              std::pair<const i3bar_data::block *, plugin_id::type>,
+              std::pair<const i3bar_data::block *, plugin_id::type>>
+              separators{make_separators(cur_plugin_id)};
+
+          i3bar_protocol::update_statusline(
+              content_cache.first[cur_plugin_id], cur_plugin_id,
+              content_string_cache, *separators.first.first,
+              separators.first.second, *separators.second.first,
+              separators.second.second, separator_string_cache, true);
+        } else {
+          i3bar_protocol::update_statusline(
+              content_cache.first[cur_plugin_id], cur_plugin_id,
+              content_string_cache, true);
+        }
+        frame_scheduler.add_change();
+      }
+    }};
+
+    const auto post_history{[&]() -> void {
+      for (const plugin_id::type cur_plugin_id : history_pending) {
+        update_queue.put(cur_plugin_id);
+      }
+      history_pending.clear();
+    }};
+
+    const auto write_frame{[&]() -> void {
+      const bool was_stalled{statusline_writer.is_stalled()};
+      if (config.general.custom_separators) {
+        i3bar_protocol::print_statusline(content_string_cache,
+                                         separator_string_cache, true,
+                                         statusline_writer);
+      } else {
+        i3bar_protocol::print_statusline(content_string_cache, true,
+                                         statusline_writer);
+      }
+      // only registered while stalled, epoll does not accept regular files
+      if ((!was_stalled) && statusline_writer.is_stalled()) {
+        event_loop.add(statusline_writer.get_fd(), EPOLLOUT,
+                       static_cast<std::uint32_t>(event_source::output));
+      }
+      if (frame_scheduler.frame_pending()) {
+        frame_scheduler.frame_written(frame_scheduler::clock::now());
+      }
+      for (const plugin_id::type cur_plugin_id : clicks_traced) {
+        metrics::click_rendered(cur_plugin_id);
+      }
+      clicks_traced.clear();
+      post_history();
+    }};
 
-          for (plugin_id::type i{0}; i < plugin_count; ++i) {
-            if (!hide_block::get(content_cache.first[i])) {
-              content_cache.first[i].data.program = make_block::content(
-                  config.theme, content_cache.second[i],
-                  (((plugin_id_to_active_index[i]) % 2) != 0),
-                  config.general.custom_separators);
+    while (true) {
+      for (const epoll_event &event : event_loop.wait()) {
+        switch (static_cast<event_source>(event.data.u32)) {
+        case event_source::update_queue: {
+          // cleared before draining, a put() racing with the drain re-arms it
+          update_queue.clear_notification();
+          // only the ids queued so far, so that a fast plugin cannot keep the
+          // frame timer and signals waiting
+          for (std::size_t remaining{update_queue.count().load()};
+               remaining != 0; --remaining) {
+            apply_update(update_queue.get());
+          }
+          if (update_queue.count().load() != 0) {
+            update_queue.notify();
+          }
+          if ((!output_stopped) && frame_scheduler.frame_pending() &&
+              (!frame_timer.is_armed())) {
+            const frame_scheduler::clock::time_point now{
+                frame_scheduler::clock::now()};
+            const frame_scheduler::clock::time_point next_frame{
+                frame_scheduler.next_frame(now)};
+            if (next_frame <= now) {
+              write_frame();
+            } else {
+              frame_timer.arm(next_frame);
             }
           }
-
-          if (config.general.custom_separators) {
-            i3bar_protocol::print_statusline(
-                content_cache.first, content_string_cache,
-                [plugin_count, &plugin_id_to_active_index,
-                 &active_index_to_plugin_id, &make_separator_left,
-                 &make_separator_right]() -> std::vector<i3bar_data::block> {
-                  if (active_index_to_plugin_id.front() == plugin_id::null) {
-                    return std::vector<i3bar_data::block>{
-                        (plugin_count + 1),
-                        i3bar_data::block{.data{.plugin{hide_block::set<
-                            struct i3bar_data::block::data::plugin>()}}}};
-                  } else {
-                    std::vector<i3bar_data::block> ret_val;
-                    ret_val.reserve(plugin_count + 1);
-                    plugin_id::type last_plugin_id{plugin_id::null};
-                    for (plugin_id::type i{0}; i < plugin_count; ++i) {
-                      if ((active_index_to_plugin_id[i] == plugin_id::null) &&
-                          (last_plugin_id == plugin_id::null)) {
-                        last_plugin_id = active_index_to_plugin_id[i - 1];
-                      }
-                      ret_val.emplace_back(
-                          make_separator_left(
-                              (plugin_id_to_active_index[i] != plugin_id::null)
-                                  ? (i)
-                                  : (plugin_id::null))
-                              .first);
-                    }
-                    last_plugin_id = ((last_plugin_id == plugin_id::null)
-                                          ? (plugin_count - 1)
-                                          : (last_plugin_id));
-                    ret_val.emplace_back(
-                        make_separator_right(last_plugin_id).first);
-                    return ret_val;
-                  }
-                }(),
-                separator_string_cache, true);
-          } else {
-            i3bar_protocol::print_statusline(content_cache.first,
-                                             content_string_cache, true);
+          if (!frame_scheduler.frame_pending()) {
+            post_history(); // nothing changed, so no frame to wait for
           }
-
-        } else if (!hide_current) {
-          content_cache.first[cur_plugin_id].data.program = make_block::content(
-              config.theme, content_cache.second[cur_plugin_id],
-              (((plugin_id_to_active_index[cur_plugin_id]) % 2) != 0),
-              config.general.custom_separators);
-
-          if (config.general.custom_separators) {
-            const std::pair<std::pair<i3bar_data::block, plugin_id::type>,
-                            std::pair<i3bar_data::block, plugin_id::type>>
-                separators{make_separators(cur_plugin_id)};
-
-            i3bar_protocol::print_statusline(
-                content_cache.first[cur_plugin_id], cur_plugin_id,
-                content_string_cache, separators.first.first,
-                separators.first.second, separators.second.first,
-                separators.second.second, separator_string_cache, true);
-          } else {
-            i3bar_protocol::print_statusline(content_cache.first[cur_plugin_id],
-                                             cur_plugin_id,
-                                             content_string_cache, true);
+        } break;
+        case event_source::frame_timer: {
+          frame_timer.clear();
+          if ((!output_stopped) && frame_scheduler.frame_pending()) {
+            write_frame();
           }
+        } break;
+        case event_source::signal: {
+          for (int signal{signal_fd.read()}; signal != 0;
+               signal = signal_fd.read()) {
+            if (signal == metrics::dump_signal()) {
+              metrics::print();
+            } else if ((signal == stop_signal) && (!output_stopped)) {
+              output_stopped = true;
+              frame_timer.disarm();
+              for (plugin_handle &cur_plugin_handle : plugin_handles) {
+                cur_plugin_handle.stop();
+              }
+            } else if ((signal == cont_signal) && output_stopped) {
+              output_stopped = false;
+              // updates received while stopped are already in the caches
+              write_frame();
+              for (plugin_handle &cur_plugin_handle : plugin_handles) {
+                cur_plugin_handle.cont();
+              }
+            }
+          }
+        } break;
+        case event_source::output: {
+          if (statusline_writer.flush()) {
+            event_loop.remove(statusline_writer.get_fd());
+          }
+        } break;
+        default: {
+          throw bits_and_bytes::unreachable_error{};
+        } break;
         }
       }
     }
@@ -1,7 +1,9 @@
 #include "make_block.hpp"
 
 #include "block_state.hpp"
+#include "hide_block.hpp"
 #include "i3bar_data.hpp"
+#include "i3bar_protocol.hpp"
 #include "plugin_id.hpp"
 #include "theme.hpp"
 
@@ -11,7 +13,9 @@
 #include <cstddef>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <variant>
+#include <vector>
 
 struct i3neostatus::i3bar_data::block::data::program
 i3neostatus::make_block::content(const theme::theme &theme,
@@ -71,6 +75,104 @@ struct i3neostatus::i3bar_data::block i3neostatus::make_block::separator(
   };
 }
 
+i3neostatus::make_block::theme_table::theme_table(
+    const theme::theme &theme, const bool custom_separators)
+    : m_content_serialized(m_k_content_count),
+      m_content(m_k_content_count),
+      m_separators_serialized(
+          ((custom_separators) ? (m_k_content_count * (m_k_content_count + 2))
+                               : (0))),
+      m_separators(m_separators_serialized.size()),
+      m_hidden_separator{.data{
+          .plugin{hide_block::set<struct i3bar_data::block::data::plugin>()}}},
+      m_alternating_tint{false} {
+  for (std::size_t state{0}; state < static_cast<std::size_t>(block_state::max);
+       ++state) {
+    for (const bool tint : {false, true}) {
+      const std::size_t index{
+          content_index(static_cast<block_state>(state), tint)};
+      m_content[index] = make_block::content(
+          theme, static_cast<block_state>(state), tint, custom_separators);
+      m_content_serialized[index] =
+          i3bar_protocol::serialize_program(m_content[index]);
+      m_content[index].serialized = &m_content_serialized[index];
+    }
+    m_alternating_tint =
+        (m_alternating_tint ||
+         (m_content_serialized[content_index(static_cast<block_state>(state),
+                                             false)] !=
+          m_content_serialized[content_index(static_cast<block_state>(state),
+                                             true)]));
+  }
+
+  if (!custom_separators) {
+    return;
+  }
+  const auto set_separator{[this, &theme](const std::size_t index,
+                                          const program *left,
+                                          const program *right) -> void {
+    m_separators[index] = make_block::separator(
+        theme, ((left) ? (&left->theme) : (nullptr)),
+        ((right) ? (&right->theme) : (nullptr)));
+    m_separators_serialized[index] =
+        i3bar_protocol::serialize_program(m_separators[index].data.program);
+    m_separators[index].data.program.serialized =
+        &m_separators_serialized[index];
+  }};
+  for (std::size_t left{0}; left < m_k_content_count; ++left) {
+    set_separator(left, nullptr, &m_content[left]);
+    set_separator((m_k_content_count + left), &m_content[left], nullptr);
+    for (std::size_t right{0}; right < m_k_content_count; ++right) {
+      set_separator((((2 + left) * m_k_content_count) + right),
+                    &m_content[left], &m_content[right]);
+    }
+  }
+}
+
+const i3neostatus::make_block::theme_table::program &
+i3neostatus::make_block::theme_table::content(const block_state state,
+                                              const bool apply_tint) const {
+  return m_content[content_index(state, apply_tint)];
+}
+
+const i3neostatus::i3bar_data::block &
+i3neostatus::make_block::theme_table::separator(const program *left,
+                                                const program *right) const {
+  assert((left || right) && (!m_separators.empty()));
+  if (left && right) {
+    return m_separators[((2 + content_index(*left)) * m_k_content_count) +
+                        content_index(*right)];
+  } else if (left) {
+    return m_separators[m_k_content_count + content_index(*left)];
+  } else {
+    return m_separators[content_index(*right)];
+  }
+}
+
+const i3neostatus::i3bar_data::block &
+i3neostatus::make_block::theme_table::hidden_separator() const {
+  return m_hidden_separator;
+}
+
+bool i3neostatus::make_block::theme_table::has_alternating_tint() const {
+  return m_alternating_tint;
+}
+
+std::size_t
+i3neostatus::make_block::theme_table::content_index(const block_state state,
+                                                    const bool apply_tint) {
+  return ((static_cast<std::size_t>(state) * 2) + ((apply_tint) ? (1) : (0)));
+}
+
+std::size_t i3neostatus::make_block::theme_table::content_index(
+    const program &program) const {
+  assert((program.serialized >= m_content_serialized.data()) &&
+         (program.serialized <
+          (m_content_serialized.data() + m_content_serialized.size())));
+  return static_cast<std::size_t>(program.serialized -
+                                  m_content_serialized.data());
+}
+
 struct i3neostatus::i3bar_data::block::data::program::theme
 i3neostatus::make_block::impl::content_theme(const theme::theme &theme,
                                              const block_state state,
@@ -5,6 +5,10 @@
 #include "i3bar_data.hpp"
 #include "theme.hpp"
 
+#include <cstddef>
+#include <string>
+#include <vector>
+
 namespace i3neostatus {
 namespace make_block {
 struct i3bar_data::block::data::program content(const theme::theme &theme,
@@ -17,6 +21,61 @@ separator(const theme::theme &theme,
           const struct i3bar_data::block::data::program::theme *left,
           const struct i3bar_data::block::data::program::theme *right);
 
+// every program part (and separator) a block can get from the theme, built
+// once when the config is loaded, together with its serialized form so that
+// re-theming a block is a table lookup. there are block_state::max states,
+// each with and without the alternating tint, separators are indexed by the
+// content blocks to their left and right
+class theme_table {
+public:
+  using program = struct i3bar_data::block::data::program;
+
+private:
+  static constexpr std::size_t m_k_content_count{
+      static_cast<std::size_t>(block_state::max) * 2};
+
+private:
+  // both indexed by content_index(), m_content[i].serialized points into
+  // m_content_serialized
+  std::vector<std::string> m_content_serialized;
+  std::vector<program> m_content;
+  // begin separators (by the right block), then end separators (by the left
+  // block), then middle separators (by the left, then the right block)
+  std::vector<std::string> m_separators_serialized;
+  std::vector<i3bar_data::block> m_separators;
+  i3bar_data::block m_hidden_separator;
+  bool m_alternating_tint;
+
+public:
+  theme_table(const theme::theme &theme, const bool custom_separators);
+  // moving the vectors keeps the serialized pointers valid, copying would not
+  theme_table(theme_table &&other) noexcept = default;
+  theme_table(const theme_table &other) = delete;
+
+public:
+  ~theme_table() = default;
+
+public:
+  theme_table &operator=(theme_table &&other) noexcept = default;
+  theme_table &operator=(const theme_table &other) = delete;
+
+public:
+  const program &content(const block_state state, const bool apply_tint) const;
+  // left and right have to come from content(), at least one of them not
+  // nullptr
+  const i3bar_data::block &separator(const program *left,
+                                     const program *right) const;
+  const i3bar_data::block &hidden_separator() const;
+  // false if applying the alternating tint never changes a serialized block,
+  // i.e. blocks do not have to be re-themed when their position changes
+  bool has_alternating_tint() const;
+
+private:
+  static std::size_t content_index(const block_state state,
+                                   const bool apply_tint);
+  std::size_t content_index(const program &program) const;
+};
+
 namespace impl {
 constexpr struct i3bar_data::block::data::program::global
 global(bool custom_separators) {
@@ -0,0 +1,272 @@
+#include "metrics.hpp"
+
+#include "thread_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ios>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+struct i3neostatus::metrics::global i3neostatus::metrics::global {};
+std::vector<struct i3neostatus::metrics::plugin>
+    i3neostatus::metrics::plugins{};
+std::chrono::steady_clock::time_point i3neostatus::metrics::impl::last_print{};
+std::vector<i3neostatus::thread_stats::usage>
+    i3neostatus::metrics::impl::last_usage{};
+
+void i3neostatus::metrics::init(const std::size_t plugin_count) {
+  plugins = std::vector<struct plugin>(plugin_count);
+  impl::last_print = std::chrono::steady_clock::now();
+  impl::last_usage = std::vector<thread_stats::usage>(plugin_count);
+}
+
+void i3neostatus::metrics::add_wakeup(const std::size_t plugin,
+                                      const thread_stats::usage &before,
+                                      const thread_stats::usage &after) {
+  struct plugin &cur_plugin{plugins[plugin]};
+  cur_plugin.wakeups.fetch_add(1, std::memory_order_relaxed);
+  cur_plugin.voluntary_switches.fetch_add(
+      (after.voluntary_switches - before.voluntary_switches),
+      std::memory_order_relaxed);
+  cur_plugin.cpu_time_us.fetch_add((after.cpu_time_us - before.cpu_time_us),
+                                   std::memory_order_relaxed);
+}
+
+void i3neostatus::metrics::add_latency(histogram &histogram,
+                                       const std::chrono::nanoseconds latency) {
+  const std::uint64_t us{static_cast<std::uint64_t>(std::max<std::int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count(),
+      0))};
+  histogram
+      .buckets[std::min<std::size_t>(std::bit_width(us),
+                                     (histogram::k_buckets - 1))]
+      .fetch_add(1, std::memory_order_relaxed);
+  std::uint64_t max_us{histogram.max_us.load(std::memory_order_relaxed)};
+  while ((us > max_us) && (!histogram.max_us.compare_exchange_weak(
+                              max_us, us, std::memory_order_relaxed))) {
+  }
+}
+
+void i3neostatus::metrics::click_read(const std::size_t plugin) {
+  std::int64_t expected{0};
+  plugins[plugin].click_read_ns.compare_exchange_strong(expected,
+                                                        impl::now_ns());
+}
+
+void i3neostatus::metrics::click_dispatched(const std::size_t plugin) {
+  struct plugin &cur_plugin{plugins[plugin]};
+  const std::int64_t read{cur_plugin.click_read_ns.load()};
+  std::int64_t expected{0};
+  const std::int64_t now{impl::now_ns()};
+  if ((read != 0) &&
+      cur_plugin.click_dispatch_ns.compare_exchange_strong(expected, now)) {
+    add_latency(cur_plugin.click_dispatch_us,
+                std::chrono::nanoseconds{now - read});
+  }
+}
+
+void i3neostatus::metrics::block_put(const std::size_t plugin) {
+  struct plugin &cur_plugin{plugins[plugin]};
+  const std::int64_t read{cur_plugin.click_read_ns.load()};
+  std::int64_t expected{0};
+  const std::int64_t now{impl::now_ns()};
+  // a put before the click was even handed over is not its result
+  if ((read != 0) && (cur_plugin.click_dispatch_ns.load() != 0) &&
+      cur_plugin.click_put_ns.compare_exchange_strong(expected, now)) {
+    add_latency(cur_plugin.click_put_us, std::chrono::nanoseconds{now - read});
+  }
+}
+
+bool i3neostatus::metrics::block_applied(const std::size_t plugin) {
+  struct plugin &cur_plugin{plugins[plugin]};
+  // the previous traced click is not rendered yet, this one waits
+  if ((cur_plugin.click_applied_ns != 0) ||
+      (cur_plugin.click_put_ns.load() == 0)) {
+    return false;
+  }
+  cur_plugin.click_applied_ns = cur_plugin.click_read_ns.load();
+  cur_plugin.click_put_ns.store(0);
+  cur_plugin.click_dispatch_ns.store(0);
+  // last, so that the next click does not pair with the stamps above
+  cur_plugin.click_read_ns.store(0);
+  return true;
+}
+
+void i3neostatus::metrics::click_rendered(const std::size_t plugin) {
+  struct plugin &cur_plugin{plugins[plugin]};
+  if (cur_plugin.click_applied_ns != 0) {
+    add_latency(cur_plugin.click_render_us,
+                std::chrono::nanoseconds{impl::now_ns() -
+                                         cur_plugin.click_applied_ns});
+    cur_plugin.click_applied_ns = 0;
+  }
+}
+
+void i3neostatus::metrics::block_suppressed(const std::size_t plugin) {
+  if (block_applied(plugin)) {
+    plugins[plugin].click_applied_ns = 0;
+  }
+}
+
+void i3neostatus::metrics::print(std::ostream &stream /*= std::cerr*/) {
+  const std::chrono::steady_clock::time_point now{
+      std::chrono::steady_clock::now()};
+  const double interval_s{
+      std::chrono::duration<double>{now - impl::last_print}.count()};
+  impl::last_print = now;
+
+  stream << "global:";
+  impl::print_counter(stream, "updates_received", global.updates_received);
+  impl::print_counter(stream, "update_wakeups", global.update_wakeups);
+  impl::print_counter(stream, "frames_written", global.frames_written);
+  impl::print_counter(stream, "frames_dropped", global.frames_dropped);
+  impl::print_counter(stream, "frames_superseded", global.frames_superseded);
+  impl::print_counter(stream, "output_stalls", global.output_stalls);
+  impl::print_counter(stream, "output_stall_time_us",
+                      global.output_stall_time_us);
+  impl::print_counter(stream, "poll_workers", global.poll_workers);
+  impl::print_counter(stream, "timer_wakeups", global.timer_wakeups);
+  impl::print_counter(stream, "timers_fired", global.timers_fired);
+  impl::print_rate(stream, "rate_interval_s", interval_s);
+  stream << '\n';
+  for (std::size_t i{0}; i < plugins.size(); ++i) {
+    stream << "plugin " << i << ':';
+    impl::print_counter(stream, "updates_suppressed",
+                        plugins[i].updates_suppressed);
+    impl::print_counter(stream, "history_overflows",
+                        plugins[i].history_overflows);
+    impl::print_counter(stream, "polls", plugins[i].polls);
+    impl::print_counter(stream, "poll_time_us", plugins[i].poll_time_us);
+    impl::print_counter(stream, "poll_overruns", plugins[i].poll_overruns);
+    impl::print_counter(stream, "clicks_dropped", plugins[i].clicks_dropped);
+    impl::print_counter(stream, "invalid_utf8", plugins[i].invalid_utf8);
+    impl::print_histogram(stream, "click_dispatch_us",
+                          plugins[i].click_dispatch_us);
+    impl::print_histogram(stream, "click_put_us", plugins[i].click_put_us);
+    impl::print_histogram(stream, "click_render_us",
+                          plugins[i].click_render_us);
+    const thread_stats::usage usage{impl::sample_usage(i)};
+    const thread_stats::usage &last{impl::last_usage[i]};
+    impl::print_value(stream, "wakeups", usage.wakeups);
+    impl::print_value(stream, "voluntary_switches", usage.voluntary_switches);
+    impl::print_value(stream, "cpu_time_us", usage.cpu_time_us);
+    if (interval_s > 0) {
+      // a thread exiting between two samples may make a total go back
+      auto per_s{[interval_s](const std::uint64_t cur,
+                              const std::uint64_t prev) -> double {
+        return ((cur > prev) ? (static_cast<double>(cur - prev) / interval_s)
+                             : (0.0));
+      }};
+      impl::print_rate(stream, "wakeups_per_s",
+                       per_s(usage.wakeups, last.wakeups));
+      impl::print_rate(
+          stream, "voluntary_switches_per_s",
+          per_s(usage.voluntary_switches, last.voluntary_switches));
+      // cpu time in us per second / 10'000 = percent of one cpu
+      impl::print_rate(stream, "cpu_percent",
+                       (per_s(usage.cpu_time_us, last.cpu_time_us) / 10'000));
+    }
+    impl::last_usage[i] = usage;
+    stream << '\n';
+  }
+  stream << std::flush;
+}
+
+i3neostatus::thread_stats::usage
+i3neostatus::metrics::impl::sample_usage(const std::size_t plugin) {
+  const struct plugin &cur_plugin{plugins[plugin]};
+  thread_stats::usage ret_val{
+      .wakeups{cur_plugin.wakeups.load(std::memory_order_relaxed)},
+      .voluntary_switches{
+          cur_plugin.voluntary_switches.load(std::memory_order_relaxed)},
+      .cpu_time_us{cur_plugin.cpu_time_us.load(std::memory_order_relaxed)}};
+  if (const pid_t tid{cur_plugin.thread_id.load()}; tid != 0) {
+    if (const std::optional<thread_stats::usage> thread_usage{
+            thread_stats::read_task(tid)};
+        thread_usage) {
+      ret_val.wakeups += thread_usage->wakeups;
+      ret_val.voluntary_switches += thread_usage->voluntary_switches;
+      ret_val.cpu_time_us += thread_usage->cpu_time_us;
+    }
+  }
+  return ret_val;
+}
+
+std::int64_t i3neostatus::metrics::impl::now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::uint64_t
+i3neostatus::metrics::impl::percentile(const histogram &histogram,
+                                       const double fraction) {
+  std::uint64_t total{0};
+  for (const counter &cur_bucket : histogram.buckets) {
+    total += cur_bucket.load(std::memory_order_relaxed);
+  }
+  if (total == 0) {
+    return 0;
+  }
+  const std::uint64_t rank{std::max<std::uint64_t>(
+      static_cast<std::uint64_t>(
+          std::ceil(fraction * static_cast<double>(total))),
+      1)};
+  std::uint64_t seen{0};
+  for (std::size_t i{0}; i < histogram::k_buckets; ++i) {
+    seen += histogram.buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      // bucket i holds values below 2^i
+      return std::min<std::uint64_t>(
+          ((std::uint64_t{1} << i) - 1),
+          histogram.max_us.load(std::memory_order_relaxed));
+    }
+  }
+  return histogram.max_us.load(std::memory_order_relaxed);
+}
+
+void i3neostatus::metrics::impl::print_counter(std::ostream &stream,
+                                               const char *name,
+                                               const counter &value) {
+  print_value(stream, name, value.load(std::memory_order_relaxed));
+}
+
+void i3neostatus::metrics::impl::print_value(std::ostream &stream,
+                                             const char *name,
+                                             const std::uint64_t value) {
+  stream << ' ' << name << '=' << value;
+}
+
+void i3neostatus::metrics::impl::print_rate(std::ostream &stream,
+                                            const char *name,
+                                            const double value) {
+  const std::ios_base::fmtflags flags{stream.flags()};
+  const std::streamsize precision{stream.precision()};
+  stream << ' ' << name << '=' << std::fixed << std::setprecision(2) << value;
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+void i3neostatus::metrics::impl::print_histogram(std::ostream &stream,
+                                                 const char *name,
+                                                 const histogram &histogram) {
+  std::uint64_t total{0};
+  for (const counter &cur_bucket : histogram.buckets) {
+    total += cur_bucket.load(std::memory_order_relaxed);
+  }
+  // nothing traced yet
+  if (total == 0) {
+    return;
+  }
+  stream << ' ' << name << "_p50=" << percentile(histogram, 0.5) << ' '
+         << name << "_p99=" << percentile(histogram, 0.99) << ' ' << name
+         << "_max=" << histogram.max_us.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,129 @@
+#ifndef I3NEOSTATUS_METRICS_HPP
+#define I3NEOSTATUS_METRICS_HPP
+
+#include "thread_stats.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace i3neostatus {
+namespace metrics {
+using counter = std::atomic<std::uint64_t>;
+
+// latencies in power of two buckets of microseconds, bucket i counts the
+// values with a bit width of i (0, 1, 2-3, 4-7, ...), the last one
+// everything above. percentiles are reported as the upper end of their
+// bucket
+struct histogram {
+  static constexpr std::size_t k_buckets{32};
+
+  std::array<counter, k_buckets> buckets;
+  counter max_us;
+};
+
+struct global {
+  counter updates_received;
+  counter update_wakeups;
+  counter frames_written;
+  counter frames_dropped;
+  counter frames_superseded;
+  counter output_stalls;
+  counter output_stall_time_us;
+  counter poll_workers;
+  counter timer_wakeups;
+  counter timers_fired;
+};
+
+struct plugin {
+  counter updates_suppressed;
+  counter history_overflows;
+  counter polls;
+  counter poll_time_us;
+  counter poll_overruns;
+  // discarded from a full click mailbox
+  counter clicks_dropped;
+  // blocks put with ill-formed UTF-8 in full_text/short_text/min_width,
+  // which was replaced
+  counter invalid_utf8;
+  // for plugins on the shared threads, accumulated around every poll/resume
+  counter wakeups;
+  counter voluntary_switches;
+  counter cpu_time_us;
+  // plugins with a thread of their own are read from /proc while it runs
+  std::atomic<pid_t> thread_id;
+  // from a click being read to on_click_event() (or click()), to the next
+  // put_block() and to the next status line showing that block
+  histogram click_dispatch_us;
+  histogram click_put_us;
+  histogram click_render_us;
+  // the click being traced, steady_clock nanoseconds, 0 while unset
+  std::atomic<std::int64_t> click_read_ns;
+  std::atomic<std::int64_t> click_dispatch_ns;
+  std::atomic<std::int64_t> click_put_ns;
+  std::int64_t click_applied_ns; // main thread only
+};
+
+extern struct global global;
+// indexed by plugin_id, sized by init()
+extern std::vector<struct plugin> plugins;
+
+void init(const std::size_t plugin_count);
+// one wakeup of a plugin on a shared thread, between two read_self()
+void add_wakeup(const std::size_t plugin, const thread_stats::usage &before,
+                const thread_stats::usage &after);
+void add_latency(histogram &histogram, const std::chrono::nanoseconds latency);
+
+// click-to-render tracing, of one click per plugin at a time: the first one
+// read after the previous traced click was applied, the clicks in between
+// are not traced. a click whose block does not change the status line is
+// dropped from the trace
+// click event listener thread
+void click_read(const std::size_t plugin);
+// the plugin's execution context, before handing the event over
+void click_dispatched(const std::size_t plugin);
+// any thread, counts once the traced click has been dispatched
+void block_put(const std::size_t plugin);
+// main thread, the plugin's block went into the status line, true if it was
+// the traced click's, which click_rendered() then completes
+bool block_applied(const std::size_t plugin);
+void click_rendered(const std::size_t plugin);
+// main thread, the plugin's block was the same as the one shown
+void block_suppressed(const std::size_t plugin);
+
+// wakeups, context switches and cpu time are also printed as rates since
+// the previous print (or init()), click latencies as p50/p99/max
+void print(std::ostream &stream = std::cerr);
+
+// e.g. `pkill -RTMIN i3neostatus`
+inline int dump_signal() { return SIGRTMIN; }
+
+namespace impl {
+extern std::chrono::steady_clock::time_point last_print;
+extern std::vector<thread_stats::usage> last_usage;
+
+thread_stats::usage sample_usage(const std::size_t plugin);
+std::int64_t now_ns();
+// upper end of the bucket holding the given fraction of the values, 0 if
+// there are none
+std::uint64_t percentile(const histogram &histogram, const double fraction);
+
+void print_counter(std::ostream &stream, const char *name,
+                   const counter &value);
+void print_value(std::ostream &stream, const char *name,
+                 const std::uint64_t value);
+void print_rate(std::ostream &stream, const char *name, const double value);
+void print_histogram(std::ostream &stream, const char *name,
+                     const histogram &histogram);
+} // namespace impl
+} // namespace metrics
+} // namespace i3neostatus
+
+#endif
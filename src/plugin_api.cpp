@@ -3,42 +3,67 @@
 #include "hide_block.hpp"
 #include "i3bar_data.hpp"
 #include "i3bar_protocol.hpp"
+#include "metrics.hpp"
 #include "thread_comm.hpp"
+#include "timer_wheel.hpp"
 
 #include "libconfigfile/libconfigfile.hpp"
 
+#include <cstddef>
 #include <exception>
 #include <string>
+#include <type_traits>
 #include <utility>
 
+static_assert(std::is_same_v<i3neostatus::plugin_api::timer_clock,
+                             i3neostatus::timer_wheel::clock>);
+static_assert(std::is_same_v<i3neostatus::plugin_api::timer_id,
+                             i3neostatus::timer_wheel::timer_id>);
+
 const std::string i3neostatus::plugin_api::config_out::k_valid_name_chars{
     "abcdefghijklmnopqrstuvqxyzABCDEFGHIJKLMNOPQRSTUVQXYZ_-"};
 
 i3neostatus::plugin_api::plugin_api(
-    thread_comm::producer<block> *thread_comm_producer)
-    : m_thread_comm_producer{thread_comm_producer} {}
+    thread_comm::producer<block> *thread_comm_producer,
+    timer_wheel *timer_wheel, const std::size_t id)
+    : m_thread_comm_producer{thread_comm_producer},
+      m_timer_wheel{timer_wheel}, m_id{id} {}
 
 i3neostatus::plugin_api::plugin_api(plugin_api &&other) noexcept
-    : m_thread_comm_producer{other.m_thread_comm_producer} {
+    : m_thread_comm_producer{other.m_thread_comm_producer},
+      m_timer_wheel{other.m_timer_wheel}, m_id{other.m_id} {
   other.m_thread_comm_producer = nullptr;
+  other.m_timer_wheel = nullptr;
 }
 
-i3neostatus::plugin_api::~plugin_api() {}
+i3neostatus::plugin_api::~plugin_api() {
+  if (m_timer_wheel != nullptr) {
+    m_timer_wheel->cancel_all(m_id);
+  }
+}
 
 i3neostatus::plugin_api &
 i3neostatus::plugin_api::operator=(plugin_api &&other) noexcept {
   if (this != &other) {
+    if (m_timer_wheel != nullptr) {
+      m_timer_wheel->cancel_all(m_id);
+    }
     m_thread_comm_producer = other.m_thread_comm_producer;
+    m_timer_wheel = other.m_timer_wheel;
+    m_id = other.m_id;
     other.m_thread_comm_producer = nullptr;
+    other.m_timer_wheel = nullptr;
   }
   return *this;
 }
 
 void i3neostatus::plugin_api::put_block(const block &block) {
+  metrics::block_put(m_id);
   m_thread_comm_producer->put_value(block);
 }
 
 void i3neostatus::plugin_api::put_block(block &&block) {
+  metrics::block_put(m_id);
   m_thread_comm_producer->put_value(std::move(block));
 }
 
@@ -62,3 +87,38 @@ void i3neostatus::plugin_api::hide() {
   put_block(block{hide_block::set<struct i3bar_data::block::data::plugin>(),
                   block_state::idle});
 }
+
+i3neostatus::plugin_api::timer_id
+i3neostatus::plugin_api::schedule_at(const timer_clock::time_point expiry,
+                                     timer_callback &&callback) {
+  return m_timer_wheel->schedule_at(
+      expiry,
+      [this, callback{std::move(callback)}]() {
+        try {
+          callback();
+        } catch (...) {
+          put_error(std::current_exception());
+        }
+      },
+      m_id);
+}
+
+i3neostatus::plugin_api::timer_id
+i3neostatus::plugin_api::every(const timer_clock::duration interval,
+                               timer_callback &&callback,
+                               const bool aligned /*= true*/) {
+  return m_timer_wheel->every(
+      interval,
+      [this, callback{std::move(callback)}]() {
+        try {
+          callback();
+        } catch (...) {
+          put_error(std::current_exception());
+        }
+      },
+      aligned, m_id);
+}
+
+void i3neostatus::plugin_api::cancel_timer(const timer_id id) {
+  m_timer_wheel->cancel(id);
+}
@@ -6,7 +6,11 @@
 
 #include "libconfigfile/libconfigfile.hpp"
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
+#include <functional>
 #include <string>
 #include <utility>
 
@@ -16,12 +20,33 @@ namespace thread_comm {
 template <typename t_value> class producer;
 }
 
+class timer_wheel;
+
 class plugin_api {
 public:
   using config_in = libconfigfile::map_node;
 
+  // what to discard when a plugin with a history puts a block while the
+  // history is full, or a click event is sent while its mailbox is full
+  enum class drop_policy {
+    oldest,
+    newest,
+  };
+
   struct config_out {
     bool click_events_enabled;
+    // 0 keeps only the latest block, otherwise up to history_depth blocks are
+    // queued and shown in order, one frame each
+    std::size_t history_depth{0};
+    drop_policy history_drop{drop_policy::oldest};
+    // click events not yet handled by on_click_event() (or click()) are
+    // queued, up to click_depth of them
+    std::size_t click_depth{16};
+    drop_policy click_drop{drop_policy::oldest};
+    // if not 0, a scroll event is held back this long, and further scrolls
+    // in the same direction arriving meanwhile are merged into it
+    // (click_event::scroll_delta)
+    std::chrono::milliseconds scroll_coalescing{0};
 
     static const std::string k_valid_name_chars;
   };
@@ -30,11 +55,18 @@ public:
   using block = std::pair<content, block_state>;
   using click_event = struct i3bar_data::click_event::data;
 
+  using timer_clock = std::chrono::steady_clock;
+  using timer_id = std::uint64_t;
+  using timer_callback = std::function<void()>;
+
 private:
   thread_comm::producer<block> *m_thread_comm_producer;
+  timer_wheel *m_timer_wheel;
+  std::size_t m_id; // of the plugin, owns its timers
 
 public:
-  plugin_api(thread_comm::producer<block> *thread_comm_producer);
+  plugin_api(thread_comm::producer<block> *thread_comm_producer,
+             timer_wheel *timer_wheel, const std::size_t id);
   plugin_api(plugin_api &&other) noexcept;
   plugin_api(const plugin_api &other) = delete;
 
@@ -53,6 +85,19 @@ public:
   void put_error(std::exception &&error);
 
   void hide();
+
+  // timers shared with every other plugin, timers due at about the same time
+  // fire in one wakeup. the callback is called on the timer thread and must
+  // not block, e.g. it should only wake the plugin's own thread. an exception
+  // thrown by it is put as an error. timers are cancelled before the plugin
+  // is destroyed
+  timer_id schedule_at(const timer_clock::time_point expiry,
+                       timer_callback &&callback);
+  // if aligned, fires on multiples of interval since the system_clock epoch
+  // (e.g. whole seconds) instead of one interval from now
+  timer_id every(const timer_clock::duration interval,
+                 timer_callback &&callback, const bool aligned = true);
+  void cancel_timer(const timer_id id);
 };
 
 } // namespace i3neostatus
@@ -6,3 +6,7 @@ void i3neostatus::plugin_base::on_click_event(
     plugin_api::click_event &&click_event) {
   (void)click_event;
 }
+
+void i3neostatus::plugin_base::on_stop() {}
+
+void i3neostatus::plugin_base::on_cont() {}
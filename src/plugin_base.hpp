@@ -20,6 +20,10 @@ public:
   virtual void term() = 0;
 
   virtual void on_click_event(plugin_api::click_event &&click_event);
+
+  virtual void on_stop();
+
+  virtual void on_cont();
 };
 
 } // namespace i3neostatus
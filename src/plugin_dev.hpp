@@ -2,10 +2,12 @@
 #define I3NEOSTATUS_PLUGIN_DEV_HPP
 
 #include "block_state.hpp"
+#include "coro_plugin_base.hpp"
 #include "i3bar_data.hpp"
 #include "plugin_api.hpp"
 #include "plugin_base.hpp"
 #include "plugin_factory.hpp"
+#include "poll_plugin_base.hpp"
 
 #include "libconfigfile/libconfigfile.hpp"
 
@@ -13,6 +15,10 @@ namespace i3neostatus {
 namespace plugin_dev {
 using base = i3neostatus::plugin_base;
 using api = i3neostatus::plugin_api;
+using coro_base = i3neostatus::coro_plugin_base;
+using poll_base = i3neostatus::poll_plugin_base;
+using coro_api = i3neostatus::coro_api;
+using task = i3neostatus::coro_task;
 
 using state = i3neostatus::block_state;
 using content = i3neostatus::plugin_api::content;
@@ -20,6 +26,7 @@ using block = i3neostatus::plugin_api::block;
 using click_event = i3neostatus::plugin_api::click_event;
 using config_in = i3neostatus::plugin_api::config_in;
 using config_out = i3neostatus::plugin_api::config_out;
+using drop_policy = i3neostatus::plugin_api::drop_policy;
 
 namespace types = i3neostatus::i3bar_data::types;
 } // namespace plugin_dev
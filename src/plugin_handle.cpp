@@ -1,18 +1,30 @@
 #include "plugin_handle.hpp"
 
+#include "click_mailbox.hpp"
+#include "coro_executor.hpp"
+#include "coro_plugin_base.hpp"
+#include "metrics.hpp"
 #include "plugin_api.hpp"
 #include "plugin_base.hpp"
 #include "plugin_error.hpp"
 #include "plugin_id.hpp"
+#include "poll_plugin_base.hpp"
+#include "poll_pool.hpp"
 #include "thread_comm.hpp"
+#include "thread_stats.hpp"
+#include "timer_wheel.hpp"
 
 #include "bits-and-bytes/generic_callback.hpp"
 #include "libconfigfile/libconfigfile.hpp"
 
+#include <cstddef>
+#include <exception>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <variant>
 
@@ -40,17 +52,31 @@ const i3neostatus::thread_comm::shared_state_state
         thread_comm::shared_state_state::value |
         thread_comm::shared_state_state::exception};
 
+const i3neostatus::coro_executor::done_callback
+    i3neostatus::plugin_handle::m_k_done_callback{
+        [](void *userdata, std::exception_ptr exception) -> void {
+          if (exception) {
+            static_cast<plugin_handle *>(userdata)->put_error(exception);
+          }
+        }};
+
 i3neostatus::plugin_handle::plugin_handle(
     const plugin_id::type id,
     std::variant<std::filesystem::path, std::string> &&path_or_name,
     libconfigfile::map_node &&conf,
-    state_change_callback &&state_change_callback)
+    const std::optional<std::size_t> history_depth,
+    const std::optional<plugin_api::drop_policy> history_drop,
+    const std::optional<std::size_t> click_depth,
+    const std::optional<plugin_api::drop_policy> click_drop,
+    thread_comm::shared_state_arena<plugin_api::block> &comm_arena,
+    timer_wheel &timer_wheel, state_change_callback &&state_change_callback)
     : m_id{id}, m_path_or_name{std::move(path_or_name)},
       m_click_events_enabled{},
       m_state_change_callback{std::move(state_change_callback)},
       m_plugin{m_path_or_name, m_id},
       m_thread_comm_producer{
           thread_comm::make<plugin_api::block, thread_comm::producer>(
+              comm_arena,
               {m_k_thread_comm_state_change_callback,
                static_cast<void *>(&m_state_change_callback)},
               m_k_state_change_subscribed_events)},
@@ -59,8 +85,10 @@ i3neostatus::plugin_handle::plugin_handle(
       m_thread_comm_producer_plugin{
           thread_comm::make_from<thread_comm::producer>(
               m_thread_comm_consumer)},
-      m_plugin_api{&m_thread_comm_producer_plugin}, m_plugin_thread{} {
-  do_ctor(std::move(conf));
+      m_plugin_api{&m_thread_comm_producer_plugin, &timer_wheel, m_id},
+      m_plugin_thread{}, m_click_mailbox{nullptr}, m_click_pool{nullptr} {
+  do_ctor(std::move(conf), history_depth, history_drop, click_depth,
+          click_drop, timer_wheel);
 }
 
 i3neostatus::plugin_handle::plugin_handle(plugin_handle &&other) noexcept
@@ -73,9 +101,14 @@ i3neostatus::plugin_handle::plugin_handle(plugin_handle &&other) noexcept
       m_thread_comm_producer_plugin{
           std::move(other.m_thread_comm_producer_plugin)},
       m_plugin_api{std::move(other.m_plugin_api)},
-      m_plugin_thread{std::move(other.m_plugin_thread)} {}
+      m_plugin_thread{std::move(other.m_plugin_thread)},
+      m_click_mailbox{std::move(other.m_click_mailbox)},
+      m_click_pool{std::exchange(other.m_click_pool, nullptr)} {}
 
 i3neostatus::plugin_handle::~plugin_handle() {
+  if (m_click_pool != nullptr) {
+    m_click_pool->detach_clicks(m_id);
+  }
   try {
     m_plugin.get().term();
   } catch (const std::exception &ex) {
@@ -85,7 +118,9 @@ i3neostatus::plugin_handle::~plugin_handle() {
     m_thread_comm_producer.put_exception(
         std::make_exception_ptr(plugin_error{m_id, m_path_or_name, "UNKNOWN"}));
   }
-  m_plugin_thread.join();
+  if (m_plugin_thread.joinable()) {
+    m_plugin_thread.join();
+  }
 }
 
 i3neostatus::plugin_handle &
@@ -102,17 +137,36 @@ i3neostatus::plugin_handle::operator=(plugin_handle &&other) noexcept {
         std::move(other.m_thread_comm_producer_plugin);
     m_plugin_api = std::move(other.m_plugin_api);
     m_plugin_thread = std::move(other.m_plugin_thread);
+    m_click_mailbox = std::move(other.m_click_mailbox);
+    m_click_pool = std::exchange(other.m_click_pool, nullptr);
   }
   return *this;
 }
 
-void i3neostatus::plugin_handle::do_ctor(libconfigfile::map_node &&conf) {
-  const plugin_api plugin_api{&m_thread_comm_producer_plugin};
+void i3neostatus::plugin_handle::do_ctor(
+    libconfigfile::map_node &&conf,
+    const std::optional<std::size_t> history_depth,
+    const std::optional<plugin_api::drop_policy> history_drop,
+    const std::optional<std::size_t> click_depth,
+    const std::optional<plugin_api::drop_policy> click_drop,
+    timer_wheel &timer_wheel) {
+  const plugin_api plugin_api{&m_thread_comm_producer_plugin, nullptr, m_id};
 
   try {
     plugin_api::config_out conf_out{
         m_plugin.get().init(&m_plugin_api, std::move(conf))};
     m_click_events_enabled = conf_out.click_events_enabled;
+    // the config file takes precedence over what the plugin asks for, the
+    // plugin thread is not running yet so nothing has been put
+    m_thread_comm_consumer.set_history(
+        history_depth.value_or(conf_out.history_depth),
+        (history_drop.value_or(conf_out.history_drop) ==
+         plugin_api::drop_policy::oldest),
+        &metrics::plugins[m_id].history_overflows);
+    m_click_mailbox = std::make_unique<click_mailbox>(
+        click_depth.value_or(conf_out.click_depth),
+        click_drop.value_or(conf_out.click_drop), &timer_wheel,
+        conf_out.scroll_coalescing, &metrics::plugins[m_id].clicks_dropped);
   } catch (const std::exception &ex) {
     throw plugin_error{m_id, m_path_or_name, ex.what()};
   } catch (...) {
@@ -120,24 +174,90 @@ void i3neostatus::plugin_handle::do_ctor(libconfigfile::map_node &&conf) {
   }
 }
 
-void i3neostatus::plugin_handle::run() {
+void i3neostatus::plugin_handle::run(coro_executor &executor,
+                                      poll_pool &pool) {
+  if (coro_plugin_base *coro_plugin{
+          dynamic_cast<coro_plugin_base *>(&m_plugin.get())};
+      coro_plugin != nullptr) {
+    try {
+      coro_plugin->start(executor, &m_plugin_api, m_id, m_click_mailbox.get(),
+                         m_k_done_callback, static_cast<void *>(this));
+    } catch (...) {
+      put_error(std::current_exception());
+    }
+    return;
+  } else if (poll_plugin_base *poll_plugin{
+                 dynamic_cast<poll_plugin_base *>(&m_plugin.get())};
+             poll_plugin != nullptr) {
+    try {
+      poll_plugin->start(pool, m_id, m_k_done_callback,
+                         static_cast<void *>(this));
+    } catch (...) {
+      put_error(std::current_exception());
+    }
+    pool.attach_clicks(m_id, poll_plugin, m_click_mailbox.get(),
+                       m_k_done_callback, static_cast<void *>(this));
+    m_click_pool = &pool;
+    return;
+  }
+  // run() keeps the thread busy, clicks are delivered by the pool
+  pool.attach_clicks(m_id, &m_plugin.get(), m_click_mailbox.get(),
+                     m_k_done_callback, static_cast<void *>(this));
+  m_click_pool = &pool;
   m_plugin_thread = std::thread{[this]() {
+    thread_stats::set_name(std::visit(
+        [](auto &&path_or_name) -> std::string {
+          if constexpr (std::is_same_v<
+                            std::remove_cvref_t<decltype(path_or_name)>,
+                            std::filesystem::path>) {
+            return path_or_name.stem().string();
+          } else {
+            return path_or_name;
+          }
+        },
+        m_path_or_name));
+    struct metrics::plugin &cur_metrics{metrics::plugins[m_id]};
+    cur_metrics.thread_id.store(thread_stats::get_tid());
     try {
       m_plugin.get().run();
-    } catch (const std::exception &ex) {
-      m_thread_comm_producer.put_exception(std::make_exception_ptr(
-          plugin_error{m_id, m_path_or_name, ex.what()}));
     } catch (...) {
-      m_thread_comm_producer.put_exception(std::make_exception_ptr(
-          plugin_error{m_id, m_path_or_name, "UNKNOWN"}));
+      put_error(std::current_exception());
+    }
+    // keep the totals once /proc no longer lists the thread
+    const std::optional<thread_stats::usage> usage{
+        thread_stats::read_task(thread_stats::get_tid())};
+    cur_metrics.thread_id.store(0);
+    if (usage) {
+      cur_metrics.wakeups.fetch_add(usage->wakeups,
+                                    std::memory_order_relaxed);
+      cur_metrics.voluntary_switches.fetch_add(usage->voluntary_switches,
+                                               std::memory_order_relaxed);
+      cur_metrics.cpu_time_us.fetch_add(usage->cpu_time_us,
+                                        std::memory_order_relaxed);
     }
   }};
 }
 
 void i3neostatus::plugin_handle::send_click_event(
     plugin_api::click_event &&click_event) {
+  m_click_mailbox->put(std::move(click_event));
+}
+
+void i3neostatus::plugin_handle::stop() {
   try {
-    m_plugin.get().on_click_event(std::move(click_event));
+    m_plugin.get().on_stop();
+  } catch (const std::exception &ex) {
+    m_thread_comm_producer.put_exception(
+        std::make_exception_ptr(plugin_error{m_id, m_path_or_name, ex.what()}));
+  } catch (...) {
+    m_thread_comm_producer.put_exception(
+        std::make_exception_ptr(plugin_error{m_id, m_path_or_name, "UNKNOWN"}));
+  }
+}
+
+void i3neostatus::plugin_handle::cont() {
+  try {
+    m_plugin.get().on_cont();
   } catch (const std::exception &ex) {
     m_thread_comm_producer.put_exception(
         std::make_exception_ptr(plugin_error{m_id, m_path_or_name, ex.what()}));
@@ -164,3 +284,16 @@ i3neostatus::thread_comm::consumer<i3neostatus::plugin_api::block> &
 i3neostatus::plugin_handle::get_comm() {
   return m_thread_comm_consumer;
 }
+
+void i3neostatus::plugin_handle::put_error(
+    const std::exception_ptr &exception) {
+  try {
+    std::rethrow_exception(exception);
+  } catch (const std::exception &ex) {
+    m_thread_comm_producer.put_exception(
+        std::make_exception_ptr(plugin_error{m_id, m_path_or_name, ex.what()}));
+  } catch (...) {
+    m_thread_comm_producer.put_exception(
+        std::make_exception_ptr(plugin_error{m_id, m_path_or_name, "UNKNOWN"}));
+  }
+}
@@ -1,17 +1,24 @@
 #ifndef I3NEOSTATUS_PLUGIN_HANDLE_HPP
 #define I3NEOSTATUS_PLUGIN_HANDLE_HPP
 
+#include "click_mailbox.hpp"
+#include "coro_executor.hpp"
 #include "plugin_api.hpp"
 #include "plugin_base.hpp"
 #include "plugin_id.hpp"
 #include "plugin_loader.hpp"
+#include "poll_pool.hpp"
 #include "thread_comm.hpp"
+#include "timer_wheel.hpp"
 
 #include "bits-and-bytes/generic_callback.hpp"
 #include "libconfigfile/libconfigfile.hpp"
 
 #include <filesystem>
+#include <cstddef>
+#include <exception>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <variant>
@@ -39,17 +46,30 @@ private:
   thread_comm::producer<plugin_api::block> m_thread_comm_producer_plugin;
   plugin_api m_plugin_api;
   std::thread m_plugin_thread;
+  std::unique_ptr<click_mailbox> m_click_mailbox;
+  // drains the mailbox, nullptr for coroutine plugins (drained by the
+  // executor)
+  poll_pool *m_click_pool;
 
 private:
   static const decltype(thread_comm::state_change_callback::func)
       m_k_thread_comm_state_change_callback;
   static const thread_comm::shared_state_state
       m_k_state_change_subscribed_events;
+  // shared by coroutine and poll plugins, and by the clicks delivered on the
+  // pool
+  static const coro_executor::done_callback m_k_done_callback;
 
 public:
   plugin_handle(const plugin_id::type id,
                 std::variant<std::filesystem::path, std::string> &&path_or_name,
                 libconfigfile::map_node &&conf,
+                const std::optional<std::size_t> history_depth,
+                const std::optional<plugin_api::drop_policy> history_drop,
+                const std::optional<std::size_t> click_depth,
+                const std::optional<plugin_api::drop_policy> click_drop,
+                thread_comm::shared_state_arena<plugin_api::block> &comm_arena,
+                timer_wheel &timer_wheel,
                 state_change_callback &&state_change_callback);
   plugin_handle(plugin_handle &&other) noexcept;
   plugin_handle(const plugin_handle &other) = delete;
@@ -62,12 +82,25 @@ public:
   plugin_handle &operator=(const plugin_handle &other) = delete;
 
 private:
-  void do_ctor(libconfigfile::map_node &&conf);
+  void do_ctor(libconfigfile::map_node &&conf,
+               const std::optional<std::size_t> history_depth,
+               const std::optional<plugin_api::drop_policy> history_drop,
+               const std::optional<std::size_t> click_depth,
+               const std::optional<plugin_api::drop_policy> click_drop,
+               timer_wheel &timer_wheel);
+  void put_error(const std::exception_ptr &exception);
 
 public:
-  void run();
+  // coroutine plugins are started on executor and poll plugins on pool,
+  // every other plugin gets a thread of its own
+  void run(coro_executor &executor, poll_pool &pool);
 
+  // only queues the event in the plugin's mailbox, on_click_event() is
+  // called on the executor (coroutine plugins) or on the pool (every other
+  // plugin)
   void send_click_event(plugin_api::click_event &&click_event);
+  void stop();
+  void cont();
 
   plugin_id::type get_id() const;
   const std::variant<std::filesystem::path, std::string> &
@@ -0,0 +1,50 @@
+#include "poll_plugin_base.hpp"
+
+#include "plugin_base.hpp"
+#include "poll_pool.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+
+i3neostatus::poll_plugin_base::poll_plugin_base()
+    : m_pool{nullptr}, m_id{0} {}
+
+i3neostatus::poll_plugin_base::~poll_plugin_base() {}
+
+void i3neostatus::poll_plugin_base::start(
+    poll_pool &pool, const std::size_t id,
+    void (*done)(void *userdata, std::exception_ptr exception),
+    void *userdata) {
+  m_pool = &pool;
+  m_id = id;
+  m_pool->start(m_id, this, poll_interval(), done, userdata);
+}
+
+void i3neostatus::poll_plugin_base::run() {
+  throw std::logic_error{"poll plugin run without a pool"};
+}
+
+void i3neostatus::poll_plugin_base::term() {
+  if (m_pool != nullptr) {
+    m_pool->cancel(m_id);
+  }
+}
+
+void i3neostatus::poll_plugin_base::on_stop() {
+  if (m_pool != nullptr) {
+    m_pool->stop(m_id);
+  }
+}
+
+void i3neostatus::poll_plugin_base::on_cont() {
+  if (m_pool != nullptr) {
+    m_pool->cont(m_id);
+  }
+}
+
+void i3neostatus::poll_plugin_base::poll_now() {
+  if (m_pool != nullptr) {
+    m_pool->poll_now(m_id);
+  }
+}
@@ -0,0 +1,60 @@
+#ifndef I3NEOSTATUS_POLL_PLUGIN_BASE_HPP
+#define I3NEOSTATUS_POLL_PLUGIN_BASE_HPP
+
+#include "plugin_api.hpp"
+#include "plugin_base.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+
+namespace i3neostatus {
+
+class poll_pool;
+
+// plugins deriving from this class implement poll() instead of run(). the
+// host calls poll() every poll_interval() on one of the threads of a shared
+// pool, never concurrently with itself, and skips a call if the previous one
+// is still running. term(), on_stop() and on_cont() are handled by this
+// class, on_click_event() is not. it is called on the pool as well, never
+// concurrently with poll()
+class poll_plugin_base : public plugin_base {
+private:
+  poll_pool *m_pool;
+  std::size_t m_id;
+
+public:
+  poll_plugin_base();
+
+public:
+  virtual ~poll_plugin_base() override;
+
+public:
+  // queried once, after init()
+  virtual std::chrono::milliseconds poll_interval() const = 0;
+
+  virtual void poll() = 0;
+
+  // called by plugin_handle instead of run(), done is called (on a pool
+  // thread) with the exception poll() threw, after which poll() is not
+  // called again
+  void start(poll_pool &pool, const std::size_t id,
+             void (*done)(void *userdata, std::exception_ptr exception),
+             void *userdata);
+
+public:
+  virtual void run() override final;
+
+  virtual void term() override final;
+
+  virtual void on_stop() override final;
+
+  virtual void on_cont() override final;
+
+protected:
+  // schedule a poll() as soon as possible, e.g. from on_click_event()
+  void poll_now();
+};
+
+} // namespace i3neostatus
+#endif
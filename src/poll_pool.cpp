@@ -0,0 +1,288 @@
+#include "poll_pool.hpp"
+
+#include "click_mailbox.hpp"
+#include "metrics.hpp"
+#include "plugin_api.hpp"
+#include "plugin_base.hpp"
+#include "poll_plugin_base.hpp"
+#include "thread_stats.hpp"
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+i3neostatus::poll_pool::poll_pool(timer_wheel &timer_wheel,
+                                  const std::size_t thread_count,
+                                  const std::size_t capacity)
+    : m_timer_wheel{&timer_wheel}, m_mtx{}, m_idle_cv{}, m_jobs(capacity),
+      m_worker_count{std::max<std::size_t>(thread_count, 1)},
+      m_workers{new worker[m_worker_count]}, m_next_worker{0}, m_queued{0},
+      m_exit{false}, m_threads{} {
+  for (job &cur_job : m_jobs) {
+    cur_job.timer = timer_wheel::k_no_timer;
+    cur_job.click_target = nullptr;
+    cur_job.clicks = nullptr;
+    cur_job.finished = true; // until started
+  }
+  metrics::global.poll_workers.store(m_worker_count,
+                                     std::memory_order_relaxed);
+  m_threads.reserve(m_worker_count);
+  for (std::size_t i{0}; i < m_worker_count; ++i) {
+    m_threads.emplace_back([this, i]() {
+      thread_stats::set_name("i3ns-poll");
+      run_worker(i);
+    });
+  }
+}
+
+i3neostatus::poll_pool::~poll_pool() {
+  // only left over if a plugin was never terminated
+  for (job &cur_job : m_jobs) {
+    m_timer_wheel->cancel(cur_job.timer);
+  }
+  m_exit.store(true);
+  m_queued.release(static_cast<std::ptrdiff_t>(m_worker_count));
+  for (std::thread &cur_thread : m_threads) {
+    cur_thread.join();
+  }
+}
+
+void i3neostatus::poll_pool::start(const std::size_t id,
+                                   poll_plugin_base *plugin,
+                                   const clock::duration interval,
+                                   const done_callback done, void *userdata) {
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  m_jobs[id] = job{.plugin{plugin},
+                   .done{done},
+                   .userdata{userdata},
+                   .timer{m_timer_wheel->every(
+                       std::max<clock::duration>(interval,
+                                                 std::chrono::milliseconds{1}),
+                       [this, id]() { on_due(id); }, true)},
+                   .click_target{nullptr},
+                   .clicks{nullptr},
+                   .running{false},
+                   .polling{false},
+                   .poll_due{false},
+                   .clicks_due{false},
+                   .paused{false},
+                   .finished{false}};
+  schedule_poll(id);
+}
+
+void i3neostatus::poll_pool::poll_now(const std::size_t id) {
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  const job &cur_job{m_jobs[id]};
+  // while draining clicks the poll follows right after them
+  if ((!cur_job.finished) && (!cur_job.paused) && (!cur_job.polling) &&
+      (!cur_job.poll_due)) {
+    schedule_poll(id);
+  }
+}
+
+void i3neostatus::poll_pool::stop(const std::size_t id) {
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  m_jobs[id].paused = true;
+}
+
+void i3neostatus::poll_pool::cont(const std::size_t id) {
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  job &cur_job{m_jobs[id]};
+  cur_job.paused = false;
+  if ((!cur_job.finished) && (!cur_job.polling) && (!cur_job.poll_due)) {
+    schedule_poll(id);
+  }
+}
+
+void i3neostatus::poll_pool::cancel(const std::size_t id) {
+  timer_wheel::timer_id timer;
+  {
+    std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+    m_jobs[id].finished = true;
+    timer = std::exchange(m_jobs[id].timer, timer_wheel::k_no_timer);
+  }
+  // waits for a running on_due(), which takes m_mtx
+  m_timer_wheel->cancel(timer);
+  std::unique_lock<std::mutex> lock_m_mtx{m_mtx};
+  m_idle_cv.wait(lock_m_mtx, [this, id]() { return !m_jobs[id].running; });
+}
+
+void i3neostatus::poll_pool::attach_clicks(const std::size_t id,
+                                           plugin_base *plugin,
+                                           click_mailbox *clicks,
+                                           const done_callback done,
+                                           void *userdata) {
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  job &cur_job{m_jobs[id]};
+  cur_job.done = done;
+  cur_job.userdata = userdata;
+  cur_job.click_target = plugin;
+  cur_job.clicks = clicks;
+  clicks->set_notify([this, id]() { post_clicks(id); });
+}
+
+void i3neostatus::poll_pool::post_clicks(const std::size_t id) {
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  job &cur_job{m_jobs[id]};
+  if (cur_job.clicks == nullptr) {
+    return;
+  }
+  cur_job.clicks_due = true;
+  if (!cur_job.running) {
+    dispatch(id);
+  }
+}
+
+void i3neostatus::poll_pool::detach_clicks(const std::size_t id) {
+  std::unique_lock<std::mutex> lock_m_mtx{m_mtx};
+  m_jobs[id].click_target = nullptr;
+  m_jobs[id].clicks = nullptr;
+  m_idle_cv.wait(lock_m_mtx, [this, id]() { return !m_jobs[id].running; });
+}
+
+void i3neostatus::poll_pool::on_due(const std::size_t id) {
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  job &cur_job{m_jobs[id]};
+  // paused jobs are polled again by cont()
+  if (cur_job.finished || cur_job.paused) {
+    return;
+  }
+  if (cur_job.polling || cur_job.poll_due) {
+    metrics::plugins[id].poll_overruns.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  schedule_poll(id);
+}
+
+void i3neostatus::poll_pool::schedule_poll(const std::size_t id) {
+  m_jobs[id].poll_due = true;
+  if (!m_jobs[id].running) {
+    dispatch(id);
+  }
+}
+
+void i3neostatus::poll_pool::dispatch(const std::size_t id) {
+  m_jobs[id].running = true;
+  worker &cur_worker{m_workers[m_next_worker]};
+  m_next_worker = (m_next_worker + 1) % m_worker_count;
+  {
+    std::lock_guard<std::mutex> lock_mtx{cur_worker.mtx};
+    cur_worker.jobs.push_back(id);
+  }
+  m_queued.release();
+}
+
+void i3neostatus::poll_pool::run_worker(const std::size_t index) {
+  while (true) {
+    // one permit per queued job, so some queue holds one after acquiring
+    m_queued.acquire();
+    if (m_exit.load()) {
+      return;
+    }
+    run_job(take(index));
+  }
+}
+
+std::size_t i3neostatus::poll_pool::take(const std::size_t index) {
+  while (true) {
+    for (std::size_t i{0}; i < m_worker_count; ++i) {
+      worker &cur_worker{m_workers[(index + i) % m_worker_count]};
+      std::lock_guard<std::mutex> lock_mtx{cur_worker.mtx};
+      if (!cur_worker.jobs.empty()) {
+        std::size_t id;
+        if (i == 0) {
+          id = cur_worker.jobs.front();
+          cur_worker.jobs.pop_front();
+        } else {
+          id = cur_worker.jobs.back(); // steal from the other end
+          cur_worker.jobs.pop_back();
+        }
+        return id;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+void i3neostatus::poll_pool::run_job(const std::size_t id) {
+  job &cur_job{m_jobs[id]};
+  std::unique_lock<std::mutex> lock_m_mtx{m_mtx};
+  // clicks and polls posted while one of them runs are picked up here
+  // instead of being dispatched again
+  while (true) {
+    if (cur_job.clicks_due && (cur_job.clicks != nullptr)) {
+      cur_job.clicks_due = false;
+      plugin_base *const plugin{cur_job.click_target};
+      click_mailbox *const clicks{cur_job.clicks};
+      lock_m_mtx.unlock();
+      drain_clicks(id, plugin, clicks);
+      lock_m_mtx.lock();
+    } else if (cur_job.poll_due && (!cur_job.finished)) {
+      cur_job.poll_due = false;
+      cur_job.polling = true;
+      lock_m_mtx.unlock();
+      const bool ok{poll(id)};
+      lock_m_mtx.lock();
+      cur_job.polling = false;
+      cur_job.finished = (cur_job.finished || (!ok));
+    } else {
+      break;
+    }
+  }
+  cur_job.clicks_due = false;
+  cur_job.poll_due = false;
+  cur_job.running = false;
+  lock_m_mtx.unlock();
+  m_idle_cv.notify_all();
+}
+
+bool i3neostatus::poll_pool::poll(const std::size_t id) {
+  job &cur_job{m_jobs[id]};
+  const clock::time_point begin{clock::now()};
+  const thread_stats::usage usage_begin{thread_stats::read_self()};
+  std::exception_ptr exception{nullptr};
+  try {
+    cur_job.plugin->poll();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+  metrics::add_wakeup(id, usage_begin, thread_stats::read_self());
+  metrics::plugins[id].polls.fetch_add(1, std::memory_order_relaxed);
+  metrics::plugins[id].poll_time_us.fetch_add(
+      static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              clock::now() - begin)
+              .count()),
+      std::memory_order_relaxed);
+  if (exception) {
+    cur_job.done(cur_job.userdata, exception);
+    return false;
+  }
+  return true;
+}
+
+void i3neostatus::poll_pool::drain_clicks(const std::size_t id,
+                                          plugin_base *plugin,
+                                          click_mailbox *clicks) {
+  job &cur_job{m_jobs[id]};
+  const thread_stats::usage usage_begin{thread_stats::read_self()};
+  while (std::optional<plugin_api::click_event> click_event{clicks->take()}) {
+    metrics::click_dispatched(id);
+    try {
+      plugin->on_click_event(std::move(*click_event));
+    } catch (...) {
+      cur_job.done(cur_job.userdata, std::current_exception());
+    }
+  }
+  metrics::add_wakeup(id, usage_begin, thread_stats::read_self());
+}
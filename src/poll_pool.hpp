@@ -0,0 +1,123 @@
+#ifndef I3NEOSTATUS_POLL_POOL_HPP
+#define I3NEOSTATUS_POLL_POOL_HPP
+
+#include "cache_line.hpp"
+#include "click_mailbox.hpp"
+#include "plugin_base.hpp"
+#include "poll_plugin_base.hpp"
+#include "timer_wheel.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace i3neostatus {
+
+// fixed number of worker threads calling poll_plugin_base::poll(). every job
+// has an aligned timer on the timer wheel, which hands due polls out round
+// robin to the workers' own queues, idle workers steal from the others, so
+// a poll that takes long only holds up its own worker. a poll that is due
+// while the previous one is still running is skipped (an overrun). the
+// workers also drain click mailboxes, for poll plugins in between polls and
+// for plugins with a thread of their own (which is busy in run()) as jobs
+// that are never polled, so a job runs on one worker at a time either way.
+// jobs are indexed by plugin id
+class poll_pool {
+public:
+  using clock = std::chrono::steady_clock;
+  using done_callback = void (*)(void *userdata, std::exception_ptr exception);
+
+private:
+  struct job {
+    poll_plugin_base *plugin;
+    done_callback done;
+    void *userdata;
+    timer_wheel::timer_id timer;
+    // nullptr until attach_clicks() and after detach_clicks()
+    plugin_base *click_target;
+    click_mailbox *clicks;
+    bool running; // queued or on a worker
+    bool polling;
+    bool poll_due;
+    bool clicks_due;
+    bool paused;
+    bool finished; // no further polls
+  };
+
+  struct alignas(cache_line::k_size) worker {
+    std::mutex mtx;
+    std::deque<std::size_t> jobs;
+  };
+
+private:
+  timer_wheel *m_timer_wheel;
+  std::mutex m_mtx;
+  std::condition_variable m_idle_cv;
+  std::vector<job> m_jobs;
+  std::size_t m_worker_count;
+  std::unique_ptr<worker[]> m_workers;
+  std::size_t m_next_worker;
+  std::counting_semaphore<> m_queued;
+  std::atomic<bool> m_exit;
+  std::vector<std::thread> m_threads;
+
+public:
+  poll_pool(timer_wheel &timer_wheel, const std::size_t thread_count,
+            const std::size_t capacity);
+  poll_pool(poll_pool &&other) noexcept = delete;
+  poll_pool(const poll_pool &other) = delete;
+
+public:
+  ~poll_pool();
+
+public:
+  poll_pool &operator=(poll_pool &&other) noexcept = delete;
+  poll_pool &operator=(const poll_pool &other) = delete;
+
+public:
+  // the first poll is due immediately, the next ones on multiples of
+  // interval
+  void start(const std::size_t id, poll_plugin_base *plugin,
+             const clock::duration interval, const done_callback done,
+             void *userdata);
+  void poll_now(const std::size_t id);
+  void stop(const std::size_t id);
+  void cont(const std::size_t id);
+  // no further polls, waits for a running one to return
+  void cancel(const std::size_t id);
+
+  // plugin->on_click_event() is called with the events in clicks, done
+  // is also called with the exceptions it throws (which do not end polling)
+  void attach_clicks(const std::size_t id, plugin_base *plugin,
+                     click_mailbox *clicks, const done_callback done,
+                     void *userdata);
+  // called by clicks once it has to be drained
+  void post_clicks(const std::size_t id);
+  // waits for a running on_click_event() to return
+  void detach_clicks(const std::size_t id);
+
+private:
+  // timer wheel thread
+  void on_due(const std::size_t id);
+  // these expect m_mtx to be held
+  void schedule_poll(const std::size_t id);
+  void dispatch(const std::size_t id);
+  void run_worker(const std::size_t index);
+  std::size_t take(const std::size_t index);
+  void run_job(const std::size_t id);
+  // false if poll() threw
+  bool poll(const std::size_t id);
+  void drain_clicks(const std::size_t id, plugin_base *plugin,
+                    click_mailbox *clicks);
+};
+
+} // namespace i3neostatus
+#endif
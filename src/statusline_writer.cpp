@@ -0,0 +1,152 @@
+#include "statusline_writer.hpp"
+
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+i3neostatus::statusline_writer::statusline_writer(const int fd)
+    : m_fd{fd}, m_in_flight{}, m_in_flight_written{0}, m_queued{},
+      m_stall_begin{} {
+  const int flags{fcntl(m_fd, F_GETFL)};
+  if ((flags == -1) || (fcntl(m_fd, F_SETFL, (flags | O_NONBLOCK)) == -1)) {
+    throw std::system_error{errno, std::generic_category(), "fcntl()"};
+  }
+}
+
+i3neostatus::statusline_writer::statusline_writer(
+    statusline_writer &&other) noexcept
+    : m_fd{other.m_fd}, m_in_flight{std::move(other.m_in_flight)},
+      m_in_flight_written{other.m_in_flight_written},
+      m_queued{std::move(other.m_queued)},
+      m_stall_begin{other.m_stall_begin} {
+  other.m_fd = -1;
+  other.m_in_flight_written = 0;
+}
+
+i3neostatus::statusline_writer::~statusline_writer() {}
+
+i3neostatus::statusline_writer &
+i3neostatus::statusline_writer::operator=(statusline_writer &&other) noexcept {
+  if (this != &other) {
+    m_fd = other.m_fd;
+    m_in_flight = std::move(other.m_in_flight);
+    m_in_flight_written = other.m_in_flight_written;
+    m_queued = std::move(other.m_queued);
+    m_stall_begin = other.m_stall_begin;
+
+    other.m_fd = -1;
+    other.m_in_flight_written = 0;
+  }
+  return *this;
+}
+
+bool i3neostatus::statusline_writer::write(std::span<iovec> frame) {
+  if (is_stalled()) {
+    if (!m_queued.empty()) {
+      metrics::global.frames_superseded.fetch_add(1,
+                                                  std::memory_order_relaxed);
+    }
+    m_queued.clear();
+    append(m_queued, frame);
+    return false;
+  }
+
+  std::size_t cur_iovec{0};
+  while (cur_iovec < frame.size()) {
+    const ssize_t written{writev(
+        m_fd, (frame.data() + cur_iovec),
+        static_cast<int>(std::min<std::size_t>((frame.size() - cur_iovec),
+                                               IOV_MAX)))};
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      } else if (errno == EAGAIN) {
+        break;
+      } else {
+        throw std::system_error{errno, std::generic_category(), "writev()"};
+      }
+    }
+
+    for (std::size_t remaining{static_cast<std::size_t>(written)};
+         remaining != 0;) {
+      if (remaining >= frame[cur_iovec].iov_len) {
+        remaining -= frame[cur_iovec].iov_len;
+        ++cur_iovec;
+      } else {
+        frame[cur_iovec].iov_base =
+            (static_cast<char *>(frame[cur_iovec].iov_base) + remaining);
+        frame[cur_iovec].iov_len -= remaining;
+        remaining = 0;
+      }
+    }
+  }
+
+  if (cur_iovec == frame.size()) {
+    return true;
+  } else {
+    m_in_flight.clear();
+    m_in_flight_written = 0;
+    append(m_in_flight, frame.subspan(cur_iovec));
+    m_stall_begin = clock::now();
+    metrics::global.output_stalls.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+}
+
+bool i3neostatus::statusline_writer::flush() {
+  while (is_stalled()) {
+    const ssize_t written{
+        ::write(m_fd, (m_in_flight.data() + m_in_flight_written),
+                (m_in_flight.size() - m_in_flight_written))};
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      } else if (errno == EAGAIN) {
+        return false;
+      } else {
+        throw std::system_error{errno, std::generic_category(), "write()"};
+      }
+    }
+
+    m_in_flight_written += static_cast<std::size_t>(written);
+    if (m_in_flight_written == m_in_flight.size()) {
+      m_in_flight.swap(m_queued);
+      m_queued.clear();
+      m_in_flight_written = 0;
+    }
+  }
+
+  metrics::global.output_stall_time_us.fetch_add(
+      std::chrono::duration_cast<std::chrono::microseconds>(clock::now() -
+                                                            m_stall_begin)
+          .count(),
+      std::memory_order_relaxed);
+  return true;
+}
+
+bool i3neostatus::statusline_writer::is_stalled() const {
+  return (m_in_flight_written < m_in_flight.size());
+}
+
+int i3neostatus::statusline_writer::get_fd() const { return m_fd; }
+
+void i3neostatus::statusline_writer::append(std::string &string,
+                                            std::span<const iovec> iovecs) {
+  for (const iovec &cur_iovec : iovecs) {
+    string.append(static_cast<const char *>(cur_iovec.iov_base),
+                  cur_iovec.iov_len);
+  }
+}
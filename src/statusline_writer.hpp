@@ -0,0 +1,54 @@
+#ifndef I3NEOSTATUS_STATUSLINE_WRITER_HPP
+#define I3NEOSTATUS_STATUSLINE_WRITER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <string>
+
+#include <sys/uio.h>
+
+namespace i3neostatus {
+
+// writes statuslines to a non-blocking fd, if the reader falls behind only
+// the remainder of the frame already in flight and the newest frame are kept
+class statusline_writer {
+public:
+  using clock = std::chrono::steady_clock;
+
+private:
+  int m_fd;
+  std::string m_in_flight;
+  std::size_t m_in_flight_written;
+  std::string m_queued;
+  clock::time_point m_stall_begin;
+
+public:
+  // sets O_NONBLOCK on fd, the fd is not owned
+  explicit statusline_writer(const int fd);
+  statusline_writer(statusline_writer &&other) noexcept;
+  statusline_writer(const statusline_writer &other) = delete;
+
+public:
+  ~statusline_writer();
+
+public:
+  statusline_writer &operator=(statusline_writer &&other) noexcept;
+  statusline_writer &operator=(const statusline_writer &other) = delete;
+
+public:
+  // returns false if (part of) the frame had to be buffered, flush() has to
+  // be called once the fd is writable again, iovecs are consumed
+  bool write(std::span<iovec> frame);
+  // returns true once nothing is left buffered
+  bool flush();
+
+  bool is_stalled() const;
+  int get_fd() const;
+
+private:
+  static void append(std::string &string, std::span<const iovec> iovecs);
+};
+
+} // namespace i3neostatus
+#endif
@@ -1,18 +1,20 @@
 #ifndef I3NEOSTATUS_THREAD_COMM_HPP
 #define I3NEOSTATUS_THREAD_COMM_HPP
 
+#include "cache_line.hpp"
+
 #include "bits-and-bytes/enum_flag_operators.hpp"
 #include "bits-and-bytes/generic_callback.hpp"
 #include "bits-and-bytes/is_same_template.hpp"
-#include "bits-and-bytes/unreachable_error.hpp"
 
 #include <atomic>
 #include <compare>
-#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <iostream>
-#include <mutex>
+#include <new>
+#include <optional>
 #include <tuple>
 #include <utility>
 #include <variant>
@@ -34,6 +36,7 @@ using state_change_callback =
 
 template <typename t_value> class shared_state;
 template <typename t_value> class shared_state_ptr;
+template <typename t_value> class shared_state_arena;
 template <typename t_value> class producer;
 template <typename t_value> class consumer;
 
@@ -42,103 +45,142 @@ concept concept_interface =
     bits_and_bytes::is_same_template::is_same_v<t_intf, producer> ||
     bits_and_bytes::is_same_template::is_same_v<t_intf, consumer>;
 
-template <typename t_value> class shared_state {
+// latest-value-wins channel, a put replaces any value that has not been
+// consumed yet. puts and gets only exchange pointers, the node displaced by
+// either side is kept as a spare so that steady-state puts do not allocate.
+// an exception is kept in its own slot, it takes precedence over (and
+// discards) a pending value and blocks further puts until it is consumed.
+// with set_history() values are instead kept in order in a bounded queue
+// (per-slot sequence numbers), a put into a full queue either discards the
+// oldest queued value or the new one.
+// the reference count is kept in the state itself (see shared_state_ptr),
+// each state starts on its own cache line
+template <typename t_value> class alignas(cache_line::k_size) shared_state {
 private:
-  std::variant<std::monostate, t_value, std::exception_ptr>
-      m_value_or_exception;
-  std::mutex m_value_or_exception_mtx;
-  std::condition_variable m_value_or_exception_cv;
-  enum class value_or_exception_idx : std::size_t {
-    empty = 0,
-    value = 1,
-    exception = 2,
+  struct node {
+    t_value value;
+  };
+
+  struct history_slot {
+    std::atomic<std::size_t> sequence;
+    t_value value;
   };
 
+private:
+  std::atomic<node *> m_value;
+  std::atomic<node *> m_spare;
+  std::atomic<std::exception_ptr *> m_exception;
+  std::atomic<unsigned int> m_version;
+  std::atomic<unsigned int> m_waiters;
+
+  history_slot *m_history;
+  std::size_t m_history_depth;
+  bool m_history_drop_oldest;
+  std::atomic<std::uint64_t> *m_history_overflows;
+  std::atomic<std::size_t> m_history_write;
+  std::atomic<std::size_t> m_history_read;
+
   state_change_callback m_state_change_callback;
   shared_state_state m_state_change_subscribed_events;
 
+  std::atomic<std::size_t> m_use_count;
+  bool m_in_arena;
+
 public:
   shared_state()
-      : m_value_or_exception{}, m_value_or_exception_mtx{},
+      : m_value{nullptr}, m_spare{nullptr}, m_exception{nullptr},
+        m_version{0}, m_waiters{0}, m_history{nullptr}, m_history_depth{0},
+        m_history_drop_oldest{true}, m_history_overflows{nullptr},
+        m_history_write{0}, m_history_read{0},
         m_state_change_callback{nullptr, nullptr},
-        m_state_change_subscribed_events{shared_state_state::null} {}
+        m_state_change_subscribed_events{shared_state_state::null},
+        m_use_count{1}, m_in_arena{false} {}
 
   shared_state(const state_change_callback &state_change_callback,
                const shared_state_state state_change_subscribed_events)
-      : m_value_or_exception{}, m_value_or_exception_mtx{},
+      : m_value{nullptr}, m_spare{nullptr}, m_exception{nullptr},
+        m_version{0}, m_waiters{0}, m_history{nullptr}, m_history_depth{0},
+        m_history_drop_oldest{true}, m_history_overflows{nullptr},
+        m_history_write{0}, m_history_read{0},
         m_state_change_callback{state_change_callback},
-        m_state_change_subscribed_events{state_change_subscribed_events} {}
+        m_state_change_subscribed_events{state_change_subscribed_events},
+        m_use_count{1}, m_in_arena{false} {}
 
 public:
   shared_state(const shared_state &other) = delete;
 
   shared_state(shared_state &&other) = delete;
 
-  ~shared_state() {}
+  ~shared_state() {
+    delete m_value.load(std::memory_order_relaxed);
+    delete m_spare.load(std::memory_order_relaxed);
+    delete m_exception.load(std::memory_order_relaxed);
+    delete[] m_history;
+  }
 
   shared_state &operator=(const shared_state &other) = delete;
 
   shared_state &operator=(shared_state &&other) = delete;
 
 public:
+  // must be called before any value is put, depth == 0 restores the
+  // latest-value-wins behaviour. overflows (if not nullptr) is incremented
+  // for every value that is discarded because the queue is full
+  void set_history(const std::size_t depth, const bool drop_oldest,
+                   std::atomic<std::uint64_t> *overflows = nullptr) {
+    delete[] m_history;
+    m_history = ((depth != 0) ? (new history_slot[depth]) : (nullptr));
+    m_history_depth = depth;
+    m_history_drop_oldest = drop_oldest;
+    m_history_overflows = overflows;
+    m_history_write.store(0, std::memory_order_relaxed);
+    m_history_read.store(0, std::memory_order_relaxed);
+    for (std::size_t i{0}; i < m_history_depth; ++i) {
+      m_history[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
   bool put_value(const t_value &value) {
-    std::unique_lock<std::mutex> lock_m_value_or_exception_mtx{
-        m_value_or_exception_mtx};
-    if (m_value_or_exception.index() !=
-        static_cast<std::size_t>(value_or_exception_idx::exception)) {
-      m_value_or_exception = value;
-      lock_m_value_or_exception_mtx.unlock();
-      m_value_or_exception_cv.notify_one();
-      maybe_call_callback(shared_state_state::value);
-      return true;
-    } else {
+    if (m_exception.load(std::memory_order_acquire) != nullptr) {
       return false;
     }
+    if (m_history != nullptr) {
+      t_value copy{value};
+      return put_history(copy);
+    }
+    node *new_node{m_spare.exchange(nullptr, std::memory_order_acquire)};
+    if (new_node != nullptr) {
+      new_node->value = value;
+    } else {
+      new_node = new node{value};
+    }
+    publish_value(new_node);
+    return true;
   }
 
   bool put_value(t_value &&value) {
-    std::unique_lock<std::mutex> lock_m_value_or_exception_mtx{
-        m_value_or_exception_mtx};
-    if (m_value_or_exception.index() !=
-        static_cast<std::size_t>(value_or_exception_idx::exception)) {
-      m_value_or_exception = value;
-      lock_m_value_or_exception_mtx.unlock();
-      m_value_or_exception_cv.notify_one();
-      maybe_call_callback(shared_state_state::value);
-      return true;
-    } else {
+    if (m_exception.load(std::memory_order_acquire) != nullptr) {
       return false;
     }
+    if (m_history != nullptr) {
+      return put_history(value);
+    }
+    node *new_node{m_spare.exchange(nullptr, std::memory_order_acquire)};
+    if (new_node != nullptr) {
+      new_node->value = std::move(value);
+    } else {
+      new_node = new node{std::move(value)};
+    }
+    publish_value(new_node);
+    return true;
   }
 
   bool put_exception(const std::exception_ptr &exception) {
-    std::unique_lock<std::mutex> lock_m_value_or_exception_mtx{
-        m_value_or_exception_mtx};
-    if (m_value_or_exception.index() !=
-        static_cast<std::size_t>(value_or_exception_idx::exception)) {
-      m_value_or_exception = exception;
-      lock_m_value_or_exception_mtx.unlock();
-      m_value_or_exception_cv.notify_all();
-      maybe_call_callback(shared_state_state::exception);
-      return true;
-    } else {
-      return false;
-    }
+    return publish_exception(new std::exception_ptr{exception});
   }
 
   bool put_exception(std::exception_ptr &&exception) {
-    std::unique_lock<std::mutex> lock_m_value_or_exception_mtx{
-        m_value_or_exception_mtx};
-    if (m_value_or_exception.index() !=
-        static_cast<std::size_t>(value_or_exception_idx::exception)) {
-      m_value_or_exception = exception;
-      lock_m_value_or_exception_mtx.unlock();
-      m_value_or_exception_cv.notify_all();
-      maybe_call_callback(shared_state_state::exception);
-      return true;
-    } else {
-      return false;
-    }
+    return publish_exception(new std::exception_ptr{std::move(exception)});
   }
 
   bool put_exception(const std::exception &exception) {
@@ -150,90 +192,270 @@ public:
   }
 
   std::variant<t_value, std::exception_ptr> get() {
-    std::unique_lock<std::mutex> lock_m_value_or_exception_mtx{
-        m_value_or_exception_mtx, std::defer_lock_t{}};
     while (true) {
-      lock_m_value_or_exception_mtx.lock();
-      switch (m_value_or_exception.index()) {
-      case static_cast<std::size_t>(value_or_exception_idx::empty): {
-        lock_m_value_or_exception_mtx.unlock();
-        wait();
-        continue;
-      } break;
-      case static_cast<std::size_t>(value_or_exception_idx::value):
-      case static_cast<std::size_t>(value_or_exception_idx::exception): {
-        std::variant<t_value, std::exception_ptr> ret_val{
-            [this]() -> std::variant<t_value, std::exception_ptr> {
-              switch (m_value_or_exception.index()) {
-              case static_cast<std::size_t>(value_or_exception_idx::value): {
-                return std::get<static_cast<std::size_t>(
-                    value_or_exception_idx::value)>(
-                    std::move(m_value_or_exception));
-              } break;
-              case static_cast<std::size_t>(
-                  value_or_exception_idx::exception): {
-                return std::get<static_cast<std::size_t>(
-                    value_or_exception_idx::exception)>(
-                    std::move(m_value_or_exception));
-              } break;
-              default: {
-                throw bits_and_bytes::unreachable_error{};
-              }
-              }
-            }()};
-        m_value_or_exception = std::monostate{};
-        lock_m_value_or_exception_mtx.unlock();
-        maybe_call_callback(shared_state_state::empty);
-        return ret_val;
-      } break;
+      if (std::optional<std::variant<t_value, std::exception_ptr>> ret_val{
+              try_get()};
+          ret_val.has_value()) {
+        return std::move(*ret_val);
       }
+      wait();
+    }
+  }
+
+  // get() without waiting, std::nullopt if nothing is pending
+  std::optional<std::variant<t_value, std::exception_ptr>> try_get() {
+    if (std::exception_ptr *
+        exception{m_exception.exchange(nullptr, std::memory_order_acquire)};
+        exception != nullptr) {
+      recycle(m_value.exchange(nullptr, std::memory_order_acquire));
+      for (t_value discarded{}; get_history(discarded);) {
+      }
+      std::optional<std::variant<t_value, std::exception_ptr>> ret_val{
+          std::in_place, std::in_place_index<1>, std::move(*exception)};
+      delete exception;
+      maybe_call_callback(shared_state_state::empty);
+      return ret_val;
+    } else if (node *value{
+                   m_value.exchange(nullptr, std::memory_order_acquire)};
+               value != nullptr) {
+      // only set in history mode if put before set_history(), so it is the
+      // oldest value
+      std::optional<std::variant<t_value, std::exception_ptr>> ret_val{
+          std::in_place, std::in_place_index<0>, std::move(value->value)};
+      recycle(value);
+      maybe_call_callback(shared_state_state::empty);
+      return ret_val;
+    } else if (t_value history_value{}; get_history(history_value)) {
+      maybe_call_callback(shared_state_state::empty);
+      return std::optional<std::variant<t_value, std::exception_ptr>>{
+          std::in_place, std::in_place_index<0>, std::move(history_value)};
+    } else {
+      return std::nullopt;
     }
   }
 
   void wait() {
-    std::unique_lock<std::mutex> lock_m_value_or_exception_mtx{
-        m_value_or_exception_mtx};
-    m_value_or_exception_cv.wait(
-        lock_m_value_or_exception_mtx, [this]() -> bool {
-          return m_value_or_exception.index() !=
-                 static_cast<std::size_t>(value_or_exception_idx::empty);
-        });
+    // registered before checking the slots, so that a put either sees the
+    // waiter or is seen by it (all seq_cst)
+    m_waiters.fetch_add(1);
+    while (true) {
+      const unsigned int version{m_version.load()};
+      if (pending()) {
+        break;
+      }
+      m_version.wait(version);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  bool pending() const {
+    if ((m_value.load() != nullptr) || (m_exception.load() != nullptr)) {
+      return true;
+    } else if (m_history != nullptr) {
+      const std::size_t pos{m_history_read.load()};
+      return (m_history[pos % m_history_depth].sequence.load() == (pos + 1));
+    } else {
+      return false;
+    }
   }
 
 private:
+  bool put_history(t_value &value) {
+    while (!push_history(value)) {
+      if (m_history_overflows != nullptr) {
+        m_history_overflows->fetch_add(1, std::memory_order_relaxed);
+      }
+      if (!m_history_drop_oldest) {
+        return false;
+      }
+      t_value discarded{};
+      get_history(discarded);
+    }
+    m_version.fetch_add(1);
+    if (m_waiters.load() != 0) {
+      m_version.notify_one();
+    }
+    maybe_call_callback(shared_state_state::value);
+    return true;
+  }
+
+  // value is only moved from on success
+  bool push_history(t_value &value) {
+    std::size_t pos{m_history_write.load(std::memory_order_relaxed)};
+    history_slot *slot;
+    while (true) {
+      slot = &m_history[pos % m_history_depth];
+      const std::size_t sequence{
+          slot->sequence.load(std::memory_order_acquire)};
+      if (sequence == pos) {
+        if (m_history_write.compare_exchange_weak(pos, (pos + 1),
+                                                  std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (sequence < pos) {
+        return false;
+      } else {
+        pos = m_history_write.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value = std::move(value);
+    slot->sequence.store((pos + 1), std::memory_order_release);
+    return true;
+  }
+
+  // also used by producers to discard the oldest value
+  bool get_history(t_value &value) {
+    if (m_history == nullptr) {
+      return false;
+    }
+    std::size_t pos{m_history_read.load(std::memory_order_relaxed)};
+    history_slot *slot;
+    while (true) {
+      slot = &m_history[pos % m_history_depth];
+      const std::size_t sequence{
+          slot->sequence.load(std::memory_order_acquire)};
+      if (sequence == (pos + 1)) {
+        if (m_history_read.compare_exchange_weak(pos, (pos + 1),
+                                                 std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (sequence < (pos + 1)) {
+        return false;
+      } else {
+        pos = m_history_read.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(slot->value);
+    slot->sequence.store((pos + m_history_depth), std::memory_order_release);
+    return true;
+  }
+
+  void publish_value(node *new_node) {
+    recycle(m_value.exchange(new_node));
+    m_version.fetch_add(1);
+    if (m_waiters.load() != 0) {
+      m_version.notify_one();
+    }
+    maybe_call_callback(shared_state_state::value);
+  }
+
+  bool publish_exception(std::exception_ptr *new_exception) {
+    std::exception_ptr *expected{nullptr};
+    if (!m_exception.compare_exchange_strong(expected, new_exception)) {
+      delete new_exception;
+      return false;
+    }
+    m_version.fetch_add(1);
+    if (m_waiters.load() != 0) {
+      m_version.notify_all();
+    }
+    maybe_call_callback(shared_state_state::exception);
+    return true;
+  }
+
+  void recycle(node *old_node) {
+    if (old_node != nullptr) {
+      delete m_spare.exchange(old_node, std::memory_order_acq_rel);
+    }
+  }
+
   void maybe_call_callback(const shared_state_state state) {
     if (static_cast<std::underlying_type_t<shared_state_state>>(
             m_state_change_subscribed_events & state) != 0U) {
       m_state_change_callback.call(state);
     }
   }
+
+  void acquire() { m_use_count.fetch_add(1, std::memory_order_relaxed); }
+
+  void release() {
+    if (m_use_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (m_in_arena) {
+        this->~shared_state(); // storage belongs to the arena
+      } else {
+        delete this;
+      }
+    }
+  }
+
+  friend class shared_state_ptr<t_value>;
+  friend class shared_state_arena<t_value>;
+};
+
+// storage for a fixed number of states in one allocation, sized once at
+// startup. slots are handed out in order and not reused, once they run out
+// make_shared_state_ptr() falls back to the heap. must outlive every state
+// it handed out
+template <typename t_value> class shared_state_arena {
+private:
+  std::size_t m_capacity;
+  shared_state<t_value> *m_slots;
+  std::atomic<std::size_t> m_next;
+
+public:
+  explicit shared_state_arena(const std::size_t capacity)
+      : m_capacity{capacity},
+        m_slots{static_cast<shared_state<t_value> *>(::operator new(
+            (m_capacity * sizeof(shared_state<t_value>)),
+            std::align_val_t{alignof(shared_state<t_value>)}))},
+        m_next{0} {}
+
+  shared_state_arena(const shared_state_arena &other) = delete;
+
+  shared_state_arena(shared_state_arena &&other) = delete;
+
+  ~shared_state_arena() {
+    ::operator delete(m_slots,
+                      std::align_val_t{alignof(shared_state<t_value>)});
+  }
+
+  shared_state_arena &operator=(const shared_state_arena &other) = delete;
+
+  shared_state_arena &operator=(shared_state_arena &&other) = delete;
+
+public:
+  template <typename... t_args>
+  shared_state_ptr<t_value> make_shared_state_ptr(t_args &&...args) {
+    const std::size_t index{m_next.fetch_add(1, std::memory_order_relaxed)};
+    if (index >= m_capacity) {
+      return shared_state_ptr<t_value>::make_shared_state_ptr(
+          std::forward<t_args>(args)...);
+    }
+    shared_state<t_value> *ss{
+        new (&m_slots[index]) shared_state<t_value>{
+            std::forward<t_args>(args)...}};
+    ss->m_in_arena = true;
+    return shared_state_ptr<t_value>{ss};
+  }
+
+  std::size_t capacity() const { return m_capacity; }
 };
 
+// intrusive reference count, a single pointer per handle and no separate
+// control block
 template <typename t_value> class shared_state_ptr {
 private:
   shared_state<t_value> *m_shared_state;
-  std::atomic<std::size_t> *m_use_count;
 
 public:
-  shared_state_ptr() : m_shared_state{nullptr}, m_use_count{nullptr} {}
+  shared_state_ptr() : m_shared_state{nullptr} {}
 
-  shared_state_ptr(std::nullptr_t)
-      : m_shared_state{nullptr}, m_use_count{nullptr} {}
+  shared_state_ptr(std::nullptr_t) : m_shared_state{nullptr} {}
 
+  // adopts the reference held by a newly constructed state
   explicit shared_state_ptr(shared_state<t_value> *ssp)
-      : m_shared_state{ssp}, m_use_count{new std::atomic<std::size_t>{1}} {}
+      : m_shared_state{ssp} {}
 
   shared_state_ptr(const shared_state_ptr &other)
-      : m_shared_state{other.m_shared_state}, m_use_count{other.m_use_count} {
-    if (m_use_count != nullptr) {
-      ++(*m_use_count);
+      : m_shared_state{other.m_shared_state} {
+    if (m_shared_state != nullptr) {
+      m_shared_state->acquire();
     }
   }
 
   shared_state_ptr(shared_state_ptr &&other) noexcept
-      : m_shared_state{other.m_shared_state}, m_use_count{other.m_use_count} {
+      : m_shared_state{other.m_shared_state} {
     other.m_shared_state = nullptr;
-    other.m_use_count = nullptr;
   }
 
   ~shared_state_ptr() { reset(nullptr); }
@@ -242,9 +464,8 @@ public:
     if (this != &other) {
       reset(nullptr);
       m_shared_state = other.m_shared_state;
-      m_use_count = other.m_use_count;
-      if (m_use_count != nullptr) {
-        ++(*m_use_count);
+      if (m_shared_state != nullptr) {
+        m_shared_state->acquire();
       }
     }
     return *this;
@@ -255,8 +476,6 @@ public:
       reset(nullptr);
       m_shared_state = other.m_shared_state;
       other.m_shared_state = nullptr;
-      m_use_count = other.m_use_count;
-      other.m_use_count = nullptr;
     }
     return *this;
   }
@@ -265,25 +484,15 @@ public:
   void reset() { reset(nullptr); }
 
   void reset(shared_state<t_value> *ssp) {
-    if (m_use_count != nullptr) {
-      --(*m_use_count);
-      if (*m_use_count == 0) {
-        delete m_use_count;
-        m_use_count = nullptr;
-        delete m_shared_state;
-        m_shared_state = nullptr;
-      }
-    }
-    if (ssp) {
-      m_shared_state = ssp;
-      m_use_count = new std::atomic<std::size_t>{1};
+    if (m_shared_state != nullptr) {
+      m_shared_state->release();
     }
+    m_shared_state = ssp;
   }
 
   void swap(shared_state_ptr &other) noexcept {
     using std::swap;
     swap(m_shared_state, other.m_shared_state);
-    swap(m_use_count, other.m_use_count);
   }
 
   shared_state<t_value> *get() const { return m_shared_state; }
@@ -293,8 +502,8 @@ public:
   shared_state<t_value> *operator->() const { return get(); }
 
   std::size_t use_count() const {
-    if (m_use_count != nullptr) {
-      return m_use_count->load();
+    if (m_shared_state != nullptr) {
+      return m_shared_state->m_use_count.load();
     } else {
       return 0;
     }
@@ -478,8 +687,19 @@ public:
     return m_shared_state_ptr->get();
   }
 
+  std::optional<std::variant<t_value, std::exception_ptr>> try_get() {
+    return m_shared_state_ptr->try_get();
+  }
+
   void wait() { m_shared_state_ptr->wait(); }
 
+  bool pending() const { return m_shared_state_ptr->pending(); }
+
+  void set_history(const std::size_t depth, const bool drop_oldest,
+                   std::atomic<std::uint64_t> *overflows = nullptr) {
+    m_shared_state_ptr->set_history(depth, drop_oldest, overflows);
+  }
+
   const shared_state_ptr<t_value> &get_underlying() const {
     return m_shared_state_ptr;
   }
@@ -502,6 +722,16 @@ t_intf<t_value> make(const state_change_callback &state_change_callback,
       state_change_callback, state_change_subscribed_events)};
 }
 
+template <typename t_value, template <typename> typename t_intf>
+  requires concept_interface<t_intf>
+t_intf<t_value> make(shared_state_arena<t_value> &arena,
+                     const state_change_callback &state_change_callback,
+                     const shared_state_state state_change_subscribed_events =
+                         shared_state_state::all) {
+  return t_intf<t_value>{arena.make_shared_state_ptr(
+      state_change_callback, state_change_subscribed_events)};
+}
+
 template <template <typename> typename t_intf_1, typename t_value,
           template <typename> typename t_intf_2>
   requires concept_interface<t_intf_1> && concept_interface<t_intf_2>
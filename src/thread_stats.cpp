@@ -0,0 +1,60 @@
+#include "thread_stats.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+void i3neostatus::thread_stats::set_name(const std::string_view name) {
+  static constexpr std::size_t k_max_name_length{15};
+  const std::string truncated{name.substr(0, k_max_name_length)};
+  pthread_setname_np(pthread_self(), truncated.c_str());
+}
+
+pid_t i3neostatus::thread_stats::get_tid() { return gettid(); }
+
+i3neostatus::thread_stats::usage i3neostatus::thread_stats::read_self() {
+  rusage ru{};
+  getrusage(RUSAGE_THREAD, &ru);
+  return {.wakeups{0},
+          .voluntary_switches{static_cast<std::uint64_t>(ru.ru_nvcsw)},
+          .cpu_time_us{static_cast<std::uint64_t>(
+              ((ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1'000'000) +
+              ru.ru_utime.tv_usec + ru.ru_stime.tv_usec)}};
+}
+
+std::optional<i3neostatus::thread_stats::usage>
+i3neostatus::thread_stats::read_task(const pid_t tid) {
+  const std::string dir{"/proc/self/task/" + std::to_string(tid) + '/'};
+
+  std::ifstream schedstat{dir + "schedstat"};
+  std::uint64_t run_time_ns{0};
+  std::uint64_t wait_time_ns{0};
+  std::uint64_t timeslices{0};
+  if (!(schedstat >> run_time_ns >> wait_time_ns >> timeslices)) {
+    return std::nullopt;
+  }
+
+  std::ifstream status{dir + "status"};
+  static constexpr std::string_view k_voluntary_key{
+      "voluntary_ctxt_switches:"};
+  std::uint64_t voluntary_switches{0};
+  for (std::string line; std::getline(status, line);) {
+    if (line.starts_with(k_voluntary_key)) {
+      voluntary_switches = std::stoull(line.substr(k_voluntary_key.size()));
+      break;
+    }
+  }
+
+  return usage{.wakeups{timeslices},
+               .voluntary_switches{voluntary_switches},
+               .cpu_time_us{run_time_ns / 1'000}};
+}
@@ -0,0 +1,35 @@
+#ifndef I3NEOSTATUS_THREAD_STATS_HPP
+#define I3NEOSTATUS_THREAD_STATS_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <sys/types.h>
+
+namespace i3neostatus {
+namespace thread_stats {
+struct usage {
+  std::uint64_t wakeups;
+  std::uint64_t voluntary_switches;
+  std::uint64_t cpu_time_us;
+};
+
+// names the calling thread (as shown by e.g. `top -H`), truncated to the 15
+// characters the kernel keeps
+void set_name(const std::string_view name);
+
+pid_t get_tid();
+
+// calling thread, through getrusage(RUSAGE_THREAD), which does not count
+// wakeups
+usage read_self();
+
+// any thread of this process, from /proc/self/task/<tid>/schedstat (wakeups
+// are the times the thread was scheduled in) and status. nullopt once the
+// thread has exited
+std::optional<usage> read_task(const pid_t tid);
+} // namespace thread_stats
+} // namespace i3neostatus
+
+#endif
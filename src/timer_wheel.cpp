@@ -0,0 +1,335 @@
+#include "timer_wheel.hpp"
+
+#include "event_loop.hpp"
+#include "metrics.hpp"
+#include "thread_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+i3neostatus::timer_wheel::timer_wheel(const clock::duration slack)
+    : m_slack{std::max<clock::duration>(slack, std::chrono::milliseconds{1})},
+      m_wall_offset{}, m_epoch{}, m_mtx{}, m_idle_cv{}, m_timers{},
+      m_levels{}, m_current{0}, m_armed_tick{m_k_disarmed},
+      m_next_id{k_no_timer + 1}, m_running{k_no_timer}, m_event_loop{},
+      m_timer{}, m_event_fd{eventfd(0, (EFD_NONBLOCK | EFD_CLOEXEC))},
+      m_exit{false}, m_thread{} {
+  if (m_event_fd == -1) {
+    throw std::system_error{errno, std::generic_category(), "eventfd()"};
+  }
+  const clock::time_point now{clock::now()};
+  m_wall_offset = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch() -
+      now.time_since_epoch());
+  // ticks start on a whole second, so whole seconds fall on tick boundaries
+  m_epoch = now - std::chrono::duration_cast<clock::duration>(
+                      (now.time_since_epoch() + m_wall_offset) %
+                      std::chrono::seconds{1});
+  m_current = tick_at_or_before(now);
+  m_event_loop.add(m_timer.get_fd(), EPOLLIN, 0);
+  m_event_loop.add(m_event_fd, EPOLLIN, 1);
+  m_thread = std::thread{[this]() {
+    thread_stats::set_name("i3ns-timer");
+    loop();
+  }};
+}
+
+i3neostatus::timer_wheel::~timer_wheel() {
+  {
+    std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+    m_exit = true;
+  }
+  eventfd_write(m_event_fd, 1);
+  m_thread.join();
+  close(m_event_fd);
+}
+
+i3neostatus::timer_wheel::timer_id
+i3neostatus::timer_wheel::schedule_at(const clock::time_point expiry,
+                                      callback &&func,
+                                      const owner_id owner /*= k_no_owner*/) {
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  return add(timer{.func{std::move(func)},
+                   .owner{owner},
+                   .expiry{expiry},
+                   .tick{tick_at_or_after(expiry)},
+                   .interval{clock::duration::zero()},
+                   .aligned{false},
+                   .cancelled{false}});
+}
+
+i3neostatus::timer_wheel::timer_id
+i3neostatus::timer_wheel::every(const clock::duration interval,
+                                callback &&func, const bool aligned,
+                                const owner_id owner /*= k_no_owner*/) {
+  if (interval <= clock::duration::zero()) {
+    throw std::invalid_argument{"timer_wheel::every()"};
+  }
+  std::lock_guard<std::mutex> lock_m_mtx{m_mtx};
+  const clock::time_point expiry{(aligned) ? (next_aligned(interval))
+                                           : (clock::now() + interval)};
+  return add(timer{.func{std::move(func)},
+                   .owner{owner},
+                   .expiry{expiry},
+                   .tick{tick_at_or_after(expiry)},
+                   .interval{interval},
+                   .aligned{aligned},
+                   .cancelled{false}});
+}
+
+void i3neostatus::timer_wheel::cancel(const timer_id id) {
+  std::unique_lock<std::mutex> lock_m_mtx{m_mtx};
+  cancel(lock_m_mtx, id);
+}
+
+void i3neostatus::timer_wheel::cancel_all(const owner_id owner) {
+  std::unique_lock<std::mutex> lock_m_mtx{m_mtx};
+  std::vector<timer_id> ids{};
+  for (const auto &[id, cur_timer] : m_timers) {
+    if (cur_timer.owner == owner) {
+      ids.push_back(id);
+    }
+  }
+  for (const timer_id id : ids) {
+    cancel(lock_m_mtx, id);
+  }
+}
+
+std::uint64_t i3neostatus::timer_wheel::tick_at_or_after(
+    const clock::time_point time) const {
+  if (time <= m_epoch) {
+    return 0;
+  }
+  return static_cast<std::uint64_t>(((time - m_epoch) + m_slack -
+                                     clock::duration{1}) /
+                                    m_slack);
+}
+
+std::uint64_t i3neostatus::timer_wheel::tick_at_or_before(
+    const clock::time_point time) const {
+  if (time <= m_epoch) {
+    return 0;
+  }
+  return static_cast<std::uint64_t>((time - m_epoch) / m_slack);
+}
+
+i3neostatus::timer_wheel::clock::time_point
+i3neostatus::timer_wheel::next_aligned(const clock::duration interval) const {
+  const std::chrono::nanoseconds wall{
+      (clock::now().time_since_epoch() + m_wall_offset)};
+  const std::chrono::nanoseconds step{
+      std::chrono::duration_cast<std::chrono::nanoseconds>(interval)};
+  return clock::time_point{std::chrono::duration_cast<clock::duration>(
+      (((wall / step) + 1) * step) - m_wall_offset)};
+}
+
+i3neostatus::timer_wheel::timer_id
+i3neostatus::timer_wheel::add(timer &&timer) {
+  const timer_id id{m_next_id++};
+  struct timer &cur_timer{m_timers.emplace(id, std::move(timer)).first->second};
+  insert(id, cur_timer);
+  if (cur_timer.tick < m_armed_tick) {
+    m_timer.arm(m_epoch + (m_slack * cur_timer.tick));
+    m_armed_tick = cur_timer.tick;
+  }
+  return id;
+}
+
+void i3neostatus::timer_wheel::cancel(std::unique_lock<std::mutex> &lock,
+                                      const timer_id id) {
+  const auto it{m_timers.find(id)};
+  if (it == m_timers.end()) {
+    return;
+  }
+  if (m_running != id) {
+    m_timers.erase(it);
+    return;
+  }
+  // removed by the wheel's thread once the callback returns
+  it->second.cancelled = true;
+  if (std::this_thread::get_id() != m_thread.get_id()) {
+    m_idle_cv.wait(lock, [this, id]() { return m_running != id; });
+  }
+}
+
+void i3neostatus::timer_wheel::insert(const timer_id id, timer &timer) {
+  timer.tick = std::max(timer.tick, m_current);
+  for (std::size_t i{0}; i < m_k_levels; ++i) {
+    const std::size_t shift{m_k_slot_bits * i};
+    const std::uint64_t distance{(timer.tick >> shift) - (m_current >> shift)};
+    if ((distance < m_k_slots) || (i == (m_k_levels - 1))) {
+      // too far out for the last level, it is placed again once its slot
+      // comes up
+      const std::uint64_t slot{
+          ((distance < m_k_slots) ? (timer.tick >> shift)
+                                  : ((m_current >> shift) + m_k_slots - 1)) &
+          m_k_slot_mask};
+      m_levels[i].slots[slot].push_back(id);
+      m_levels[i].occupied |= (std::uint64_t{1} << slot);
+      return;
+    }
+  }
+}
+
+void i3neostatus::timer_wheel::cascade() {
+  for (std::size_t i{1}; i < m_k_levels; ++i) {
+    const std::uint64_t slot{(m_current >> (m_k_slot_bits * i)) &
+                             m_k_slot_mask};
+    level &cur_level{m_levels[i]};
+    if ((cur_level.occupied & (std::uint64_t{1} << slot)) != 0) {
+      std::vector<timer_id> ids{std::move(cur_level.slots[slot])};
+      cur_level.slots[slot].clear();
+      cur_level.occupied &= ~(std::uint64_t{1} << slot);
+      for (const timer_id id : ids) {
+        if (const auto it{m_timers.find(id)}; it != m_timers.end()) {
+          insert(id, it->second);
+        }
+      }
+    }
+    if (slot != 0) {
+      break;
+    }
+  }
+}
+
+void i3neostatus::timer_wheel::advance(const std::uint64_t now_tick,
+                                       std::vector<timer_id> &due) {
+  if (m_timers.empty()) {
+    for (level &cur_level : m_levels) {
+      for (std::vector<timer_id> &cur_slot : cur_level.slots) {
+        cur_slot.clear();
+      }
+      cur_level.occupied = 0;
+    }
+    m_current = std::max(m_current, (now_tick + 1));
+    return;
+  }
+  level &first_level{m_levels[0]};
+  while (m_current <= now_tick) {
+    if ((m_current & m_k_slot_mask) == 0) {
+      cascade();
+    }
+    const std::uint64_t slot{m_current & m_k_slot_mask};
+    if ((first_level.occupied & (std::uint64_t{1} << slot)) != 0) {
+      due.insert(due.end(), first_level.slots[slot].begin(),
+                 first_level.slots[slot].end());
+      first_level.slots[slot].clear();
+      first_level.occupied &= ~(std::uint64_t{1} << slot);
+    }
+    // skip to the next occupied slot, but not past the next cascade
+    const std::uint64_t later{first_level.occupied &
+                              ~((std::uint64_t{2} << slot) - 1)};
+    m_current = std::min(
+        ((m_current & ~m_k_slot_mask) +
+         ((later != 0) ? (static_cast<std::uint64_t>(std::countr_zero(later)))
+                       : (m_k_slots))),
+        (now_tick + 1));
+  }
+}
+
+void i3neostatus::timer_wheel::arm() {
+  std::uint64_t earliest{m_k_disarmed};
+  for (std::size_t i{0}; i < m_k_levels; ++i) {
+    level &cur_level{m_levels[i]};
+    // slots are in expiry order starting from the current tick (level 0) or
+    // from the block after the last cascaded one (the others)
+    const std::uint64_t begin{
+        ((i == 0) || (m_current == 0))
+            ? (m_current >> (m_k_slot_bits * i))
+            : (((m_current - 1) >> (m_k_slot_bits * i)) + 1)};
+    std::uint64_t pending{std::rotr(
+        cur_level.occupied, static_cast<int>(begin & m_k_slot_mask))};
+    while (pending != 0) {
+      const std::uint64_t slot{
+          (begin + static_cast<std::uint64_t>(std::countr_zero(pending))) &
+          m_k_slot_mask};
+      pending &= (pending - 1);
+      std::vector<timer_id> &ids{cur_level.slots[slot]};
+      std::erase_if(ids, [this](const timer_id id) {
+        return !m_timers.contains(id);
+      });
+      if (ids.empty()) {
+        cur_level.occupied &= ~(std::uint64_t{1} << slot);
+        continue;
+      }
+      for (const timer_id id : ids) {
+        earliest = std::min(earliest, m_timers.find(id)->second.tick);
+      }
+      break;
+    }
+  }
+  if (earliest == m_k_disarmed) {
+    if (m_timer.is_armed()) {
+      m_timer.disarm();
+    }
+  } else if (earliest != m_armed_tick) {
+    m_timer.arm(m_epoch + (m_slack * earliest));
+  }
+  m_armed_tick = earliest;
+}
+
+void i3neostatus::timer_wheel::loop() {
+  std::vector<timer_id> due{};
+  while (true) {
+    m_event_loop.wait();
+    std::unique_lock<std::mutex> lock_m_mtx{m_mtx};
+    if (m_exit) {
+      return;
+    }
+    m_timer.clear();
+    m_armed_tick = m_k_disarmed;
+    metrics::global.timer_wakeups.fetch_add(1, std::memory_order_relaxed);
+    const clock::time_point now{clock::now()};
+    m_wall_offset = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch() -
+        now.time_since_epoch());
+    advance(tick_at_or_before(now), due);
+    for (const timer_id id : due) {
+      const auto it{m_timers.find(id)};
+      if (it == m_timers.end()) {
+        continue;
+      }
+      // stays put while running, cancel() waits for it instead of erasing
+      timer &cur_timer{it->second};
+      m_running = id;
+      lock_m_mtx.unlock();
+      cur_timer.func();
+      lock_m_mtx.lock();
+      m_running = k_no_timer;
+      metrics::global.timers_fired.fetch_add(1, std::memory_order_relaxed);
+      if ((cur_timer.cancelled) ||
+          (cur_timer.interval == clock::duration::zero())) {
+        m_timers.erase(id);
+      } else {
+        if (cur_timer.aligned) {
+          cur_timer.expiry = next_aligned(cur_timer.interval);
+        } else {
+          cur_timer.expiry += cur_timer.interval;
+          if (const clock::time_point after{clock::now()};
+              cur_timer.expiry <= after) {
+            cur_timer.expiry = after + cur_timer.interval;
+          }
+        }
+        cur_timer.tick = tick_at_or_after(cur_timer.expiry);
+        insert(id, cur_timer);
+      }
+      m_idle_cv.notify_all();
+    }
+    due.clear();
+    arm();
+  }
+}
@@ -0,0 +1,118 @@
+#ifndef I3NEOSTATUS_TIMER_WHEEL_HPP
+#define I3NEOSTATUS_TIMER_WHEEL_HPP
+
+#include "event_loop.hpp"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace i3neostatus {
+
+// the timers of every plugin (and of the poll pool) behind a single timerfd.
+// expiries are rounded up to a whole tick of slack, so timers due within the
+// same tick fire in one wakeup. level n of the wheel holds the timers due
+// within m_k_slots^(n + 1) ticks, they move down a level as the wheel turns.
+// callbacks are called on the wheel's own thread and must neither block nor
+// throw
+class timer_wheel {
+public:
+  using clock = std::chrono::steady_clock;
+  using timer_id = std::uint64_t;
+  using callback = std::function<void()>;
+  using owner_id = std::size_t;
+
+  static constexpr timer_id k_no_timer{0};
+  static constexpr owner_id k_no_owner{static_cast<owner_id>(-1)};
+
+private:
+  static constexpr std::size_t m_k_slot_bits{6};
+  static constexpr std::size_t m_k_slots{std::size_t{1} << m_k_slot_bits};
+  static constexpr std::uint64_t m_k_slot_mask{m_k_slots - 1};
+  static constexpr std::size_t m_k_levels{4};
+  static constexpr std::uint64_t m_k_disarmed{static_cast<std::uint64_t>(-1)};
+
+  struct timer {
+    callback func;
+    owner_id owner;
+    clock::time_point expiry;
+    std::uint64_t tick;
+    clock::duration interval; // zero for one-shot timers
+    bool aligned;
+    bool cancelled;
+  };
+
+  struct level {
+    std::array<std::vector<timer_id>, m_k_slots> slots;
+    std::uint64_t occupied; // one bit per non-empty slot
+  };
+
+private:
+  clock::duration m_slack;
+  // system_clock time = clock time + m_wall_offset, refreshed every wakeup
+  // so that every aligned timer of a wakeup maps to the same tick
+  std::chrono::nanoseconds m_wall_offset;
+  clock::time_point m_epoch;
+  std::mutex m_mtx;
+  std::condition_variable m_idle_cv;
+  // removed timers may still be listed in a slot, they are skipped
+  std::unordered_map<timer_id, timer> m_timers;
+  std::array<level, m_k_levels> m_levels;
+  std::uint64_t m_current; // next tick to expire
+  std::uint64_t m_armed_tick;
+  timer_id m_next_id;
+  timer_id m_running;
+  event_loop m_event_loop;
+  timer_fd m_timer;
+  int m_event_fd;
+  bool m_exit;
+  std::thread m_thread;
+
+public:
+  explicit timer_wheel(const clock::duration slack);
+  timer_wheel(timer_wheel &&other) noexcept = delete;
+  timer_wheel(const timer_wheel &other) = delete;
+
+public:
+  ~timer_wheel();
+
+public:
+  timer_wheel &operator=(timer_wheel &&other) noexcept = delete;
+  timer_wheel &operator=(const timer_wheel &other) = delete;
+
+public:
+  // any thread
+  timer_id schedule_at(const clock::time_point expiry, callback &&func,
+                       const owner_id owner = k_no_owner);
+  // the first expiry is one interval from now, or, if aligned, the next
+  // multiple of interval since the system_clock epoch (e.g. whole seconds),
+  // so that timers with the same interval fire together
+  timer_id every(const clock::duration interval, callback &&func,
+                 const bool aligned, const owner_id owner = k_no_owner);
+  // once this returns the callback is neither running nor called again,
+  // unless it is called from the callback itself
+  void cancel(const timer_id id);
+  void cancel_all(const owner_id owner);
+
+private:
+  std::uint64_t tick_at_or_after(const clock::time_point time) const;
+  std::uint64_t tick_at_or_before(const clock::time_point time) const;
+  clock::time_point next_aligned(const clock::duration interval) const;
+  timer_id add(timer &&timer);
+  void cancel(std::unique_lock<std::mutex> &lock, const timer_id id);
+  void insert(const timer_id id, timer &timer);
+  void cascade();
+  void advance(const std::uint64_t now_tick, std::vector<timer_id> &due);
+  void arm();
+  void loop();
+};
+
+} // namespace i3neostatus
+#endif
@@ -0,0 +1,93 @@
+#include "update_queue.hpp"
+
+#include "metrics.hpp"
+#include "plugin_id.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <thread>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+i3neostatus::update_queue::update_queue(const std::size_t capacity)
+    : m_capacity{round_up_capacity(capacity)}, m_slots{new slot[m_capacity]},
+      m_event_fd{eventfd(0, (EFD_NONBLOCK | EFD_CLOEXEC))}, m_write{0},
+      m_count{0}, m_read{0} {
+  if (m_event_fd == -1) {
+    delete[] m_slots;
+    throw std::system_error{errno, std::generic_category(), "eventfd()"};
+  }
+  for (std::size_t i{0}; i < m_capacity; ++i) {
+    m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    m_slots[i].id = plugin_id::null;
+  }
+}
+
+i3neostatus::update_queue::~update_queue() {
+  close(m_event_fd);
+  delete[] m_slots;
+}
+
+bool i3neostatus::update_queue::put(const plugin_id::type id) {
+  std::size_t pos{m_write.load(std::memory_order_relaxed)};
+  slot *cur_slot;
+  while (true) {
+    cur_slot = &m_slots[pos & (m_capacity - 1)];
+    const std::size_t sequence{
+        cur_slot->sequence.load(std::memory_order_acquire)};
+    if (sequence == pos) {
+      if (m_write.compare_exchange_weak(pos, (pos + 1),
+                                        std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (sequence < pos) {
+      return false;
+    } else {
+      pos = m_write.load(std::memory_order_relaxed);
+    }
+  }
+  cur_slot->id = id;
+  cur_slot->sequence.store((pos + 1), std::memory_order_release);
+
+  if (m_count.fetch_add(1, std::memory_order_acq_rel) == 0) {
+    metrics::global.update_wakeups.fetch_add(1, std::memory_order_relaxed);
+    eventfd_write(m_event_fd, 1);
+  }
+  return true;
+}
+
+i3neostatus::plugin_id::type i3neostatus::update_queue::get() {
+  slot &cur_slot{m_slots[m_read & (m_capacity - 1)]};
+  // m_count may already include a producer that published a later slot while
+  // this one is claimed but not yet written
+  while (cur_slot.sequence.load(std::memory_order_acquire) != (m_read + 1)) {
+    std::this_thread::yield();
+  }
+  const plugin_id::type id{cur_slot.id};
+  cur_slot.sequence.store((m_read + m_capacity), std::memory_order_release);
+  ++m_read;
+  m_count.fetch_sub(1, std::memory_order_release);
+  return id;
+}
+
+const std::atomic<std::size_t> &i3neostatus::update_queue::count() const {
+  return m_count;
+}
+
+int i3neostatus::update_queue::get_fd() const { return m_event_fd; }
+
+void i3neostatus::update_queue::clear_notification() {
+  eventfd_t value{};
+  eventfd_read(m_event_fd, &value);
+}
+
+void i3neostatus::update_queue::notify() { eventfd_write(m_event_fd, 1); }
+
+std::size_t
+i3neostatus::update_queue::round_up_capacity(const std::size_t capacity) {
+  return std::bit_ceil((capacity != 0) ? (capacity) : (1));
+}
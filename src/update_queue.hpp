@@ -0,0 +1,109 @@
+#ifndef I3NEOSTATUS_UPDATE_QUEUE_HPP
+#define I3NEOSTATUS_UPDATE_QUEUE_HPP
+
+#include "cache_line.hpp"
+#include "plugin_id.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace i3neostatus {
+
+// bounded multi-producer/single-consumer ring (per-slot sequence numbers),
+// the consumer is only woken (through an eventfd) on the empty -> non-empty
+// transition
+class update_queue {
+public:
+  struct update_info {
+    plugin_id::type id;
+    class update_queue *update_queue;
+    std::atomic<bool> is_buffered;
+
+    explicit update_info(plugin_id::type id,
+                         class update_queue *update_queue = nullptr,
+                         std::atomic<bool> is_buffered = false)
+        : id{id}, update_queue{update_queue}, is_buffered{is_buffered.load()} {}
+
+    update_info(const update_info &other)
+        : id{other.id}, update_queue{other.update_queue},
+          is_buffered{other.is_buffered.load()} {}
+
+    update_info(update_info &&other) noexcept
+        : id{other.id}, update_queue{other.update_queue},
+          is_buffered{other.is_buffered.load()} {
+      other.id = plugin_id::null;
+      other.update_queue = nullptr;
+      other.is_buffered.store(false);
+    }
+
+    ~update_info() = default;
+
+    update_info &operator=(const update_info &other) {
+      if (this != &other) {
+        id = other.id;
+        update_queue = other.update_queue;
+        is_buffered.store(other.is_buffered.load());
+      }
+      return *this;
+    }
+
+    update_info &operator=(update_info &&other) noexcept {
+      if (this != &other) {
+        id = other.id;
+        update_queue = other.update_queue;
+        is_buffered.store(other.is_buffered.load());
+
+        other.id = plugin_id::null;
+        other.update_queue = nullptr;
+        other.is_buffered.store(false);
+      }
+      return *this;
+    }
+  };
+
+private:
+  struct alignas(cache_line::k_size) slot {
+    std::atomic<std::size_t> sequence;
+    plugin_id::type id;
+  };
+
+private:
+  std::size_t m_capacity;
+  slot *m_slots;
+  int m_event_fd;
+  alignas(cache_line::k_size) std::atomic<std::size_t> m_write;
+  alignas(cache_line::k_size) std::atomic<std::size_t> m_count;
+  alignas(cache_line::k_size) std::size_t m_read;
+
+public:
+  explicit update_queue(const std::size_t capacity);
+  update_queue(update_queue &&other) noexcept = delete;
+  update_queue(const update_queue &other) = delete;
+
+public:
+  ~update_queue();
+
+public:
+  update_queue &operator=(update_queue &&other) noexcept = delete;
+  update_queue &operator=(const update_queue &other) = delete;
+
+public:
+  bool put(const plugin_id::type id);
+  plugin_id::type get();
+
+  const std::atomic<std::size_t> &count() const;
+
+  // readable while a wakeup is pending, call clear_notification() before
+  // draining the queue
+  int get_fd() const;
+  void clear_notification();
+  // wakes the consumer again, for a drain that stopped with ids left (puts
+  // into a non-empty queue do not)
+  void notify();
+
+private:
+  static std::size_t round_up_capacity(const std::size_t capacity);
+};
+
+} // namespace i3neostatus
+#endif
@@ -0,0 +1,123 @@
+#include "utf8.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#endif
+
+std::size_t i3neostatus::utf8::find_invalid(const std::string_view string,
+                                            const std::size_t pos /*= 0*/) {
+  std::size_t i{impl::skip_ascii(string, pos)};
+  while (i < string.size()) {
+    const impl::sequence sequence{impl::decode(string, i)};
+    if (!sequence.valid) {
+      return i;
+    }
+    i = impl::skip_ascii(string, (i + sequence.size));
+  }
+  return string.size();
+}
+
+std::string &i3neostatus::utf8::sanitize(std::string &output,
+                                         const std::string_view string) {
+  std::size_t pos_prev{0};
+  for (std::size_t pos{find_invalid(string)}; pos < string.size();
+       pos = find_invalid(string, pos_prev)) {
+    output += string.substr(pos_prev, (pos - pos_prev));
+    output += k_replacement;
+    pos_prev = pos + impl::decode(string, pos).size;
+  }
+  output += string.substr(pos_prev);
+  return output;
+}
+
+bool i3neostatus::utf8::sanitize_in_place(std::string &string) {
+  // valid text is a single scan, without a copy
+  if (find_invalid(string) == string.size()) {
+    return false;
+  }
+  std::string sanitized{};
+  sanitized.reserve(string.size() + k_replacement.size());
+  sanitize(sanitized, string);
+  string = std::move(sanitized);
+  return true;
+}
+
+i3neostatus::utf8::impl::sequence
+i3neostatus::utf8::impl::decode(const std::string_view string,
+                                const std::size_t pos) {
+  // allowed range of the second byte, by lead byte (table 3-7 of the Unicode
+  // standard), the other continuation bytes are always 0x80 to 0xBF
+  const unsigned char lead{static_cast<unsigned char>(string[pos])};
+  std::size_t size{0};
+  unsigned char second_min{0x80};
+  unsigned char second_max{0xBF};
+  if ((lead >= 0xC2) && (lead <= 0xDF)) {
+    size = 2;
+  } else if ((lead >= 0xE0) && (lead <= 0xEF)) {
+    size = 3;
+    if (lead == 0xE0) {
+      second_min = 0xA0; // overlong
+    } else if (lead == 0xED) {
+      second_max = 0x9F; // surrogates
+    }
+  } else if ((lead >= 0xF0) && (lead <= 0xF4)) {
+    size = 4;
+    if (lead == 0xF0) {
+      second_min = 0x90; // overlong
+    } else if (lead == 0xF4) {
+      second_max = 0x8F; // above U+10FFFF
+    }
+  } else {
+    return {.size{1}, .valid{false}};
+  }
+
+  for (std::size_t i{1}; i < size; ++i) {
+    if ((pos + i) >= string.size()) {
+      return {.size{i}, .valid{false}};
+    }
+    const unsigned char cur{static_cast<unsigned char>(string[pos + i])};
+    if ((i == 1) ? ((cur < second_min) || (cur > second_max))
+                 : ((cur < 0x80) || (cur > 0xBF))) {
+      return {.size{i}, .valid{false}};
+    }
+  }
+  return {.size{size}, .valid{true}};
+}
+
+std::size_t
+i3neostatus::utf8::impl::skip_ascii(const std::string_view string,
+                                    const std::size_t pos) {
+  std::size_t i{pos};
+#if defined(__x86_64__)
+  for (; (i + sizeof(__m128i)) <= string.size(); i += sizeof(__m128i)) {
+    const unsigned int mask{static_cast<unsigned int>(
+        _mm_movemask_epi8(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(string.data() + i))))};
+    if (mask != 0) {
+      return (i + std::countr_zero(mask));
+    }
+  }
+#endif
+  static constexpr std::uint64_t k_high_bits{0x8080808080808080};
+  for (; (i + sizeof(std::uint64_t)) <= string.size();
+       i += sizeof(std::uint64_t)) {
+    std::uint64_t chunk;
+    std::memcpy(&chunk, (string.data() + i), sizeof(chunk));
+    if ((chunk & k_high_bits) != 0) {
+      break;
+    }
+  }
+  for (; i < string.size(); ++i) {
+    if ((static_cast<unsigned char>(string[i]) & 0x80) != 0) {
+      return i;
+    }
+  }
+  return string.size();
+}
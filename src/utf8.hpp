@@ -0,0 +1,41 @@
+#ifndef I3NEOSTATUS_UTF8_HPP
+#define I3NEOSTATUS_UTF8_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace i3neostatus {
+namespace utf8 {
+// U+FFFD REPLACEMENT CHARACTER
+inline constexpr std::string_view k_replacement{"\xEF\xBF\xBD"};
+
+// index of the first byte at or after pos that does not start a well-formed
+// sequence, string.size() if there is none
+std::size_t find_invalid(const std::string_view string,
+                         const std::size_t pos = 0);
+
+// appends string with every maximal ill-formed subpart (as in the Unicode
+// standard's "U+FFFD substitution of maximal subparts") replaced by
+// k_replacement
+std::string &sanitize(std::string &output, const std::string_view string);
+// sanitize() into string itself, returns whether anything was replaced
+bool sanitize_in_place(std::string &string);
+
+namespace impl {
+struct sequence {
+  std::size_t size; // of the maximal subpart if !valid, at least one
+  bool valid;
+};
+
+// the sequence starting at string[pos], which must be a non-ASCII byte
+sequence decode(const std::string_view string, const std::size_t pos);
+
+// index of the first non-ASCII byte at or after pos, string.size() if there
+// is none. checks 16 (SSE2 on x86-64) or 8 bytes at a time
+std::size_t skip_ascii(const std::string_view string, const std::size_t pos);
+} // namespace impl
+} // namespace utf8
+} // namespace i3neostatus
+
+#endif
@@ -0,0 +1,86 @@
+#include "visible_index.hpp"
+
+#include "plugin_id.hpp"
+
+#include <bit>
+#include <cassert>
+#include <vector>
+
+i3neostatus::visible_index::visible_index(const plugin_id::type size)
+    : m_tree((size + 1), 0), m_visible(size, false), m_count{0},
+      m_select_step{((size != 0) ? (std::bit_floor(size)) : (0))} {}
+
+void i3neostatus::visible_index::set(const plugin_id::type id,
+                                     const bool visible) {
+  assert(id < size());
+  if (m_visible[id] == visible) {
+    return;
+  }
+  m_visible[id] = visible;
+
+  for (plugin_id::type i{id + 1}; i < m_tree.size(); i += (i & (~i + 1))) {
+    if (visible) {
+      ++m_tree[i];
+    } else {
+      --m_tree[i];
+    }
+  }
+  if (visible) {
+    ++m_count;
+  } else {
+    --m_count;
+  }
+}
+
+bool i3neostatus::visible_index::is_visible(const plugin_id::type id) const {
+  return m_visible[id];
+}
+
+i3neostatus::plugin_id::type
+i3neostatus::visible_index::position(const plugin_id::type id) const {
+  plugin_id::type position{0};
+  for (plugin_id::type i{id}; i != 0; i -= (i & (~i + 1))) {
+    position += m_tree[i];
+  }
+  return position;
+}
+
+i3neostatus::plugin_id::type
+i3neostatus::visible_index::previous(const plugin_id::type id) const {
+  const plugin_id::type cur_position{position(id)};
+  return ((cur_position != 0) ? (select(cur_position - 1))
+                              : (plugin_id::null));
+}
+
+i3neostatus::plugin_id::type
+i3neostatus::visible_index::next(const plugin_id::type id) const {
+  return select(position(id) + ((m_visible[id]) ? (1) : (0)));
+}
+
+i3neostatus::plugin_id::type i3neostatus::visible_index::last() const {
+  return ((m_count != 0) ? (select(m_count - 1)) : (plugin_id::null));
+}
+
+i3neostatus::plugin_id::type i3neostatus::visible_index::count() const {
+  return m_count;
+}
+
+i3neostatus::plugin_id::type i3neostatus::visible_index::size() const {
+  return m_visible.size();
+}
+
+i3neostatus::plugin_id::type
+i3neostatus::visible_index::select(const plugin_id::type position) const {
+  if (position >= m_count) {
+    return plugin_id::null;
+  }
+  plugin_id::type remaining{position};
+  plugin_id::type id{0};
+  for (plugin_id::type step{m_select_step}; step != 0; step >>= 1) {
+    if (((id + step) < m_tree.size()) && (m_tree[id + step] <= remaining)) {
+      id += step;
+      remaining -= m_tree[id];
+    }
+  }
+  return id;
+}
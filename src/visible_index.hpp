@@ -0,0 +1,43 @@
+#ifndef I3NEOSTATUS_VISIBLE_INDEX_HPP
+#define I3NEOSTATUS_VISIBLE_INDEX_HPP
+
+#include "plugin_id.hpp"
+
+#include <vector>
+
+namespace i3neostatus {
+
+// set of visible plugins ordered by plugin_id, backed by a Fenwick tree so
+// that positions and neighbours are O(log n) instead of shifting arrays
+class visible_index {
+private:
+  std::vector<plugin_id::type> m_tree;
+  std::vector<bool> m_visible;
+  plugin_id::type m_count;
+  plugin_id::type m_select_step;
+
+public:
+  explicit visible_index(const plugin_id::type size);
+
+public:
+  void set(const plugin_id::type id, const bool visible);
+  bool is_visible(const plugin_id::type id) const;
+
+  // number of visible plugins before id
+  plugin_id::type position(const plugin_id::type id) const;
+  // closest visible plugins before/after id, plugin_id::null if there are
+  // none, id itself does not have to be visible
+  plugin_id::type previous(const plugin_id::type id) const;
+  plugin_id::type next(const plugin_id::type id) const;
+  plugin_id::type last() const;
+
+  plugin_id::type count() const;
+  plugin_id::type size() const;
+
+private:
+  // plugin with the given position, plugin_id::null if position >= count()
+  plugin_id::type select(const plugin_id::type position) const;
+};
+
+} // namespace i3neostatus
+#endif